@@ -18,7 +18,8 @@ typedef struct {
             unsigned int frame_id : 8;     /* Frame ID [7:0] */
             unsigned int pos_col : 10;     /* X coordinate [17:8] */
             unsigned int pos_row : 9;      /* Y coordinate [26:18] */
-            unsigned int reserved : 3;     /* Reserved bits [29:27] */
+            unsigned int size : 2;         /* Size [28:27], 16 or 32 px wide/tall */
+            unsigned int reserved : 1;     /* Reserved bit [29] */
             unsigned int flip : 1;         /* Horizontal flip [30] */
             unsigned int enable : 1;       /* Enable/Display [31] */
         } bits;
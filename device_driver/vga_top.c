@@ -4,7 +4,43 @@
  * Registers (byte offsets, 32-bit wide)
  *   0x00  CTRL_REG            W
  *   0x04  STATUS_REG          R
- *   0x80..0xFC  SPRITE[n]     R/W  (n = 0-31)
+ *   0x08  FRAME_COUNT         R
+ *   0x0C..0x18  PERF_*        R    (snapshot of the last frame)
+ *   0x1C  PERF_OVERRUN        R    (clears on read)
+ *   0x20  SCROLL              RW   (latched at vblank)
+ *   0x24  MAP                 RW   (latched at vblank)
+ *   0x28  LINE_SCROLL_IDX     RW
+ *   0x2C  LINE_SCROLL_DATA    W    (increments LINE_SCROLL_IDX)
+ *   0x30  TILEMAP_IDX         RW
+ *   0x34  TILEMAP_DATA        W    (increments TILEMAP_IDX)
+ *   0x38  SPRITE_PAT_IDX      RW
+ *   0x3C  SPRITE_PAT_DATA     W    (pixel pair, increments SPRITE_PAT_IDX)
+ *   0x40  PALETTE_IDX         RW
+ *   0x44  PALETTE_DATA        W    (RGB555, increments PALETTE_IDX)
+ *   0x48  SPRITE_PAT4_IDX     RW
+ *   0x4C  SPRITE_PAT4_DATA    W    (8 indexed pixels, increments SPRITE_PAT4_IDX)
+ *   0x50  SPRITE_PALETTE      W    ([14:8] sprite, [3:0] palette)
+ *   0x54  FG_SCROLL           RW   (latched at vblank)
+ *   0x58  FG_MAP              RW   (latched at vblank)
+ *   0x5C  FG_KEY              RW
+ *   0x60  LINE_IRQ            RW   (line and vblank interrupt enables, compare line)
+ *   0x64  IRQ_PENDING         RW   (write 1s to clear)
+ *   0x80..0xBC  TILE_ANIM[n]  W    (n = 0-15, restarts the animation)
+ *   0xC0..0xDC  HAZARD_TILES  W    (256-bit tile id mask)
+ *   0x100..0x19C  COLLISION   R    (hit, hazard, pair masks of the last frame)
+ *   0x1A0  COLQ_MAP_IDX       RW
+ *   0x1A4  COLQ_MAP_DATA      W    (class, increments COLQ_MAP_IDX)
+ *   0x1A8  COLQ_PROFILE_IDX   RW
+ *   0x1AC  COLQ_PROFILE_DATA  W    (blocked rows, increments COLQ_PROFILE_IDX)
+ *   0x1B0..0x1B4  COLQ_HAZARD W    (4 bits per class)
+ *   0x1B8  COLQ_BOUNDS        RW
+ *   0x1BC  COLQ_QUERY         W    (queues a query)
+ *   0x1C0  COLQ_RESULT        R    (takes the oldest result)
+ *   0x1C4  COLQ_STATUS        R
+ *   0x1D0..0x1F0  TEAR_LOG    R    (sprite writes during scanout, last frame)
+ *   0x200..0x3FC  SPRITE[n]   W    (n = 0-127)
+ *   0x400..0x5FC  ANIM[n]     W    (n = 0-127, restarts the animation)
+ *   0x600..0x7FC  MOTION[c]   RW   (c = 0-15, 8 words each)
  *
  */
 
@@ -21,6 +57,9 @@
 #include <linux/of_address.h>
 #include <linux/fs.h>
 #include <linux/uaccess.h>
+#include <linux/interrupt.h>
+#include <linux/of_irq.h>
+#include <linux/wait.h>
 #include "vga_top.h"
 
 #define DRIVER_NAME "vga_top"
@@ -28,7 +67,57 @@
 /* ---------- register helpers ---------- */
 #define CTRL_REG(base)     ((base) + 0x00)
 #define STATUS_REG(base)   ((base) + 0x04)
-#define SPRITE_REG(base,n) ((base) + 0x80 + ((n) * 4))
+#define FRAME_COUNT_REG(base)      ((base) + 0x08)
+#define PERF_MISSED_REG(base)      ((base) + 0x0C)
+#define PERF_DROPPED_REG(base)     ((base) + 0x10)
+#define PERF_MAX_SPRITES_REG(base) ((base) + 0x14)
+#define PERF_MAX_CYCLES_REG(base)  ((base) + 0x18)
+#define PERF_OVERRUN_REG(base)     ((base) + 0x1C)
+#define SCROLL_REG(base)           ((base) + 0x20)
+#define MAP_REG(base)              ((base) + 0x24)
+#define LINE_SCROLL_IDX_REG(base)  ((base) + 0x28)
+#define LINE_SCROLL_DATA_REG(base) ((base) + 0x2C)
+#define TILEMAP_IDX_REG(base)      ((base) + 0x30)
+#define TILEMAP_DATA_REG(base)     ((base) + 0x34)
+#define TILEMAP_ENTRIES            8192
+#define SPRITE_PAT_IDX_REG(base)   ((base) + 0x38)
+#define SPRITE_PAT_DATA_REG(base)  ((base) + 0x3C)
+#define PALETTE_IDX_REG(base)      ((base) + 0x40)
+#define PALETTE_DATA_REG(base)     ((base) + 0x44)
+#define SPRITE_PAT4_IDX_REG(base)  ((base) + 0x48)
+#define SPRITE_PAT4_DATA_REG(base) ((base) + 0x4C)
+#define SPRITE_PALETTE_REG(base)   ((base) + 0x50)
+#define FG_SCROLL_REG(base)        ((base) + 0x54)
+#define FG_MAP_REG(base)           ((base) + 0x58)
+#define FG_KEY_REG(base)           ((base) + 0x5C)
+#define LINE_IRQ_REG(base)         ((base) + 0x60)
+#define IRQ_PENDING_REG(base)      ((base) + 0x64)
+#define LINE_IRQ_EN                (1u << 31)
+#define VBLANK_IRQ_EN              (1u << 30)
+#define TILE_ANIM_REG(base,n)      ((base) + 0x80 + ((n) * 4))
+#define NUM_TILE_ANIMS             16
+#define HAZARD_TILES_REG(base,n)   ((base) + 0xC0 + ((n) * 4))
+#define COLLISION_REG(base,n)      ((base) + 0x100 + ((n) * 4))
+#define COLQ_MAP_IDX_REG(base)     ((base) + 0x1A0)
+#define COLQ_MAP_DATA_REG(base)    ((base) + 0x1A4)
+#define COLQ_PROFILE_IDX_REG(base) ((base) + 0x1A8)
+#define COLQ_PROFILE_DATA_REG(base) ((base) + 0x1AC)
+#define COLQ_HAZARD_REG(base,n)    ((base) + 0x1B0 + ((n) * 4))
+#define COLQ_BOUNDS_REG(base)      ((base) + 0x1B8)
+#define COLQ_QUERY_REG(base)       ((base) + 0x1BC)
+#define COLQ_RESULT_REG(base)      ((base) + 0x1C0)
+#define COLQ_STATUS_REG(base)      ((base) + 0x1C4)
+#define COLQ_MAP_ENTRIES           8192
+#define TEAR_LOG_REG(base,n)       ((base) + 0x1D0 + ((n) * 4))
+#define COLQ_POLLS                 1000
+#define NUM_FRAMES                 128
+#define NUM_FRAMES4                256
+#define NUM_PALETTES               16
+#define SPRITE_REG(base,n) ((base) + 0x200 + ((n) * 4))
+#define ANIM_REG(base,n)   ((base) + 0x400 + ((n) * 4))
+#define MOTION_REG(base,c,r) ((base) + 0x600 + ((c) * 32) + ((r) * 4))
+#define NUM_SPRITES        128
+#define NUM_MOTION         16
 
 /*
  * Information about our device
@@ -37,8 +126,47 @@ struct vga_top_dev {
 	struct resource res; /* Resource: our registers */
 	void __iomem *virtbase; /* Where registers can be accessed in memory */
     u32 cached_ctrl;
+	int irq;                /* 0 when the interrupt is not wired up */
+	wait_queue_head_t event_wq;
+	u32 event_seq[2];       /* events seen, per VGA_TOP_EVENT_* bit */
+	u32 event_frame[2];     /* FRAME_COUNT at the latest one */
 } dev;
 
+/*
+ * Raster interrupt: count the events that fired and wake the waiters
+ */
+static irqreturn_t vga_top_irq(int irq, void *dev_id)
+{
+	u32 pending = ioread32(IRQ_PENDING_REG(dev.virtbase)) & 0x3;
+	u32 frame;
+	int i;
+
+	if (!pending)
+		return IRQ_NONE;
+	iowrite32(pending, IRQ_PENDING_REG(dev.virtbase));
+	frame = ioread32(FRAME_COUNT_REG(dev.virtbase));
+	for (i = 0; i < 2; i++) {
+		if (pending & (1u << i)) {
+			WRITE_ONCE(dev.event_frame[i], frame);
+			WRITE_ONCE(dev.event_seq[i], dev.event_seq[i] + 1);
+		}
+	}
+	wake_up_interruptible(&dev.event_wq);
+	return IRQ_HANDLED;
+}
+
+/* The events in `wanted` that fired since `seq` was taken */
+static u8 vga_top_fired(const u32 seq[2], u8 wanted)
+{
+	u8 fired = 0;
+	int i;
+
+	for (i = 0; i < 2; i++)
+		if ((wanted & (1u << i)) && READ_ONCE(dev.event_seq[i]) != seq[i])
+			fired |= 1u << i;
+	return fired;
+}
+
 /*
  * Handle ioctl() calls from userspace:
  * Read or write the segments on single digits.
@@ -49,6 +177,35 @@ static long vga_top_ioctl(struct file *f, unsigned int cmd, unsigned long arg)
 	vga_top_ctrl_arg_t   c_arg;
 	vga_top_status_arg_t s_arg;
 	vga_top_sprite_arg_t sp_arg;
+	vga_top_anim_arg_t   a_arg;
+	vga_top_motion_arg_t m_arg;
+	vga_top_perf_arg_t   p_arg;
+	vga_top_scroll_arg_t sc_arg;
+	vga_top_map_arg_t    mp_arg;
+	vga_top_fg_map_arg_t fm_arg;
+	vga_top_line_scroll_arg_t __user *ls_user;
+	vga_top_tilemap_arg_t __user *tm_user;
+	vga_top_pattern_arg_t __user *pt_user;
+	vga_top_pattern4_arg_t __user *p4_user;
+	vga_top_palette_arg_t pl_arg;
+	vga_top_sprite_palette_arg_t sl_arg;
+	vga_top_tile_anim_arg_t ta_arg;
+	vga_top_hazard_tiles_arg_t hz_arg;
+	vga_top_collision_arg_t co_arg;
+	vga_top_colq_map_arg_t __user *cm_user;
+	vga_top_colq_classes_arg_t cc_arg;
+	vga_top_colq_arg_t cq_arg;
+	vga_top_line_irq_arg_t li_arg;
+	vga_top_event_arg_t ev_arg;
+	vga_top_tear_arg_t te_arg;
+	u32 seq[2];
+	long ret;
+	__u8 cls;
+	__u16 first, count;
+	__u8 map;
+	__u16 tile;
+	u32 v, base;
+	int i;
 
 	switch (cmd) {
 	case VGA_TOP_WRITE_CTRL:
@@ -67,11 +224,334 @@ static long vga_top_ioctl(struct file *f, unsigned int cmd, unsigned long arg)
 	case VGA_TOP_WRITE_SPRITE:
         if (copy_from_user(&sp_arg, (vga_top_sprite_arg_t *) arg, sizeof(vga_top_sprite_arg_t)))
             return -EACCES;
-		if (sp_arg.index > 31)
+		if (sp_arg.index >= NUM_SPRITES)
 			return -EINVAL;
 		iowrite32(sp_arg.attr_word, SPRITE_REG(dev.virtbase, sp_arg.index));
         break;
 
+	case VGA_TOP_WRITE_ANIM:
+		if (copy_from_user(&a_arg, (vga_top_anim_arg_t *) arg, sizeof(vga_top_anim_arg_t)))
+			return -EACCES;
+		if (a_arg.index >= NUM_SPRITES)
+			return -EINVAL;
+		iowrite32(a_arg.anim_word, ANIM_REG(dev.virtbase, a_arg.index));
+		break;
+
+	case VGA_TOP_WRITE_MOTION:
+		if (copy_from_user(&m_arg, (vga_top_motion_arg_t *) arg, sizeof(vga_top_motion_arg_t)))
+			return -EACCES;
+		if (m_arg.channel >= NUM_MOTION)
+			return -EINVAL;
+		/* Bounds and velocity before CTRL, so an enabled channel never
+		 * moves with half a setup */
+		if (m_arg.write_mask & VGA_TOP_MOTION_BOUND_X)
+			iowrite32(m_arg.bound_x, MOTION_REG(dev.virtbase, m_arg.channel, 3));
+		if (m_arg.write_mask & VGA_TOP_MOTION_BOUND_Y)
+			iowrite32(m_arg.bound_y, MOTION_REG(dev.virtbase, m_arg.channel, 4));
+		if (m_arg.write_mask & VGA_TOP_MOTION_POS)
+			iowrite32(m_arg.pos, MOTION_REG(dev.virtbase, m_arg.channel, 1));
+		if (m_arg.write_mask & VGA_TOP_MOTION_VEL)
+			iowrite32(m_arg.vel, MOTION_REG(dev.virtbase, m_arg.channel, 2));
+		if (m_arg.write_mask & VGA_TOP_MOTION_CTRL)
+			iowrite32(m_arg.ctrl, MOTION_REG(dev.virtbase, m_arg.channel, 0));
+		break;
+
+	case VGA_TOP_READ_MOTION:
+		if (copy_from_user(&m_arg, (vga_top_motion_arg_t *) arg, sizeof(vga_top_motion_arg_t)))
+			return -EACCES;
+		if (m_arg.channel >= NUM_MOTION)
+			return -EINVAL;
+		m_arg.ctrl = ioread32(MOTION_REG(dev.virtbase, m_arg.channel, 0));
+		m_arg.pos = ioread32(MOTION_REG(dev.virtbase, m_arg.channel, 1));
+		m_arg.vel = ioread32(MOTION_REG(dev.virtbase, m_arg.channel, 2));
+		m_arg.bound_x = ioread32(MOTION_REG(dev.virtbase, m_arg.channel, 3));
+		m_arg.bound_y = ioread32(MOTION_REG(dev.virtbase, m_arg.channel, 4));
+		if (copy_to_user((vga_top_motion_arg_t *) arg, &m_arg, sizeof(vga_top_motion_arg_t)))
+			return -EACCES;
+		break;
+
+	case VGA_TOP_READ_PERF:
+		p_arg.frame_count = ioread32(FRAME_COUNT_REG(dev.virtbase));
+		p_arg.missed_swaps = ioread32(PERF_MISSED_REG(dev.virtbase));
+		p_arg.dropped_sprites = ioread32(PERF_DROPPED_REG(dev.virtbase));
+		p_arg.max_line_sprites = ioread32(PERF_MAX_SPRITES_REG(dev.virtbase));
+		v = ioread32(PERF_MAX_CYCLES_REG(dev.virtbase));
+		p_arg.max_tile_cycles = v >> 16;
+		p_arg.max_sprite_cycles = v & 0xFFFF;
+		v = ioread32(PERF_OVERRUN_REG(dev.virtbase));
+		p_arg.overrun_missed = v & 0xFFFF;
+		p_arg.overrun_dropped = v >> 16;
+		if (copy_to_user((vga_top_perf_arg_t *) arg, &p_arg, sizeof(vga_top_perf_arg_t)))
+			return -EACCES;
+		break;
+
+	case VGA_TOP_WRITE_SCROLL:
+		if (copy_from_user(&sc_arg, (vga_top_scroll_arg_t *) arg, sizeof(vga_top_scroll_arg_t)))
+			return -EACCES;
+		iowrite32(((u32)(sc_arg.y & 0x3FF) << 16) | (sc_arg.x & 0x7FF),
+			  SCROLL_REG(dev.virtbase));
+		break;
+
+	case VGA_TOP_WRITE_MAP:
+		if (copy_from_user(&mp_arg, (vga_top_map_arg_t *) arg, sizeof(vga_top_map_arg_t)))
+			return -EACCES;
+		if (mp_arg.width == 0 || mp_arg.width > 128 ||
+		    mp_arg.height < 30 || mp_arg.height > 64)
+			return -EINVAL;
+		iowrite32(((u32)(mp_arg.line_scroll ? 1 : 0) << 31) |
+			  ((u32)mp_arg.height << 8) | mp_arg.width,
+			  MAP_REG(dev.virtbase));
+		break;
+
+	case VGA_TOP_WRITE_FG_SCROLL:
+		if (copy_from_user(&sc_arg, (vga_top_scroll_arg_t *) arg, sizeof(vga_top_scroll_arg_t)))
+			return -EACCES;
+		iowrite32(((u32)(sc_arg.y & 0x3FF) << 16) | (sc_arg.x & 0x7FF),
+			  FG_SCROLL_REG(dev.virtbase));
+		break;
+
+	case VGA_TOP_WRITE_FG_MAP:
+		if (copy_from_user(&fm_arg, (vga_top_fg_map_arg_t *) arg, sizeof(vga_top_fg_map_arg_t)))
+			return -EACCES;
+		if (fm_arg.width == 0 || fm_arg.width > 128 ||
+		    fm_arg.height < 30 || fm_arg.height > 64 ||
+		    fm_arg.base + fm_arg.width * fm_arg.height > TILEMAP_ENTRIES)
+			return -EINVAL;
+		iowrite32(fm_arg.key & 0x7FFF, FG_KEY_REG(dev.virtbase));
+		iowrite32(((u32)(fm_arg.enable ? 1 : 0) << 31) | ((u32)fm_arg.base << 16) |
+			  ((u32)fm_arg.height << 8) | fm_arg.width,
+			  FG_MAP_REG(dev.virtbase));
+		break;
+
+	case VGA_TOP_WRITE_LINE_SCROLL:
+		/* The table is streamed straight from user memory rather
+		 * than copied onto the kernel stack */
+		ls_user = (vga_top_line_scroll_arg_t __user *) arg;
+		if (get_user(first, &ls_user->first) || get_user(count, &ls_user->count))
+			return -EACCES;
+		if (first >= VGA_TOP_LINES || count > VGA_TOP_LINES - first)
+			return -EINVAL;
+		iowrite32(first, LINE_SCROLL_IDX_REG(dev.virtbase));
+		for (i = 0; i < count; i++) {
+			if (get_user(v, &ls_user->entries[i]))
+				return -EACCES;
+			iowrite32(v, LINE_SCROLL_DATA_REG(dev.virtbase));
+		}
+		break;
+
+	case VGA_TOP_WRITE_TILEMAP:
+		/* Cells are addressed within a map of the size last written to
+		 * MAP, or to FG_MAP for the foreground plane; the entries are
+		 * streamed from user memory */
+		tm_user = (vga_top_tilemap_arg_t __user *) arg;
+		if (get_user(map, &tm_user->map) || get_user(first, &tm_user->cell) ||
+		    get_user(count, &tm_user->count))
+			return -EACCES;
+		if (map == VGA_TOP_MAP_FG) {
+			v = ioread32(FG_MAP_REG(dev.virtbase));
+			base = (v >> 16) & 0x1FFF;
+			v = (v & 0xFF) * ((v >> 8) & 0xFF);
+		} else {
+			v = ioread32(MAP_REG(dev.virtbase));
+			v = (v & 0xFF) * ((v >> 8) & 0xFF);
+			base = map * v;
+		}
+		if (map > VGA_TOP_MAP_FG || count > VGA_TOP_TILEMAP_CHUNK || first + count > v ||
+		    base + first + count > TILEMAP_ENTRIES)
+			return -EINVAL;
+		iowrite32(base + first, TILEMAP_IDX_REG(dev.virtbase));
+		for (i = 0; i < count; i++) {
+			if (get_user(tile, &tm_user->tiles[i]))
+				return -EACCES;
+			iowrite32(tile, TILEMAP_DATA_REG(dev.virtbase));
+		}
+		break;
+
+	case VGA_TOP_WRITE_PATTERN:
+		/* Two pixels per bus write, streamed from user memory; the
+		 * pattern RAM takes 128 writes per frame */
+		pt_user = (vga_top_pattern_arg_t __user *) arg;
+		if (get_user(first, &pt_user->frame) || get_user(count, &pt_user->count))
+			return -EACCES;
+		if (count > VGA_TOP_PATTERN_CHUNK || first + count > NUM_FRAMES)
+			return -EINVAL;
+		iowrite32(first * 128, SPRITE_PAT_IDX_REG(dev.virtbase));
+		for (i = 0; i < count * 128; i++) {
+			if (get_user(v, (u32 __user *) &pt_user->pixels[2 * i]))
+				return -EACCES;
+			iowrite32(v, SPRITE_PAT_DATA_REG(dev.virtbase));
+		}
+		break;
+
+	case VGA_TOP_WRITE_PATTERN4:
+		p4_user = (vga_top_pattern4_arg_t __user *) arg;
+		if (get_user(first, &p4_user->frame) || get_user(count, &p4_user->count))
+			return -EACCES;
+		if (count > VGA_TOP_PATTERN4_CHUNK || first + count > NUM_FRAMES4)
+			return -EINVAL;
+		iowrite32(first * 32, SPRITE_PAT4_IDX_REG(dev.virtbase));
+		for (i = 0; i < count * 32; i++) {
+			if (get_user(v, &p4_user->pixels[i]))
+				return -EACCES;
+			iowrite32(v, SPRITE_PAT4_DATA_REG(dev.virtbase));
+		}
+		break;
+
+	case VGA_TOP_WRITE_PALETTE:
+		if (copy_from_user(&pl_arg, (vga_top_palette_arg_t *) arg, sizeof(vga_top_palette_arg_t)))
+			return -EACCES;
+		if (pl_arg.palette >= NUM_PALETTES)
+			return -EINVAL;
+		iowrite32(pl_arg.palette * 16, PALETTE_IDX_REG(dev.virtbase));
+		for (i = 0; i < 16; i++)
+			iowrite32(pl_arg.colors[i] & 0x7FFF, PALETTE_DATA_REG(dev.virtbase));
+		break;
+
+	case VGA_TOP_WRITE_SPRITE_PALETTE:
+		if (copy_from_user(&sl_arg, (vga_top_sprite_palette_arg_t *) arg, sizeof(vga_top_sprite_palette_arg_t)))
+			return -EACCES;
+		if (sl_arg.index >= NUM_SPRITES || sl_arg.palette >= NUM_PALETTES)
+			return -EINVAL;
+		iowrite32(((u32)sl_arg.index << 8) | sl_arg.palette, SPRITE_PALETTE_REG(dev.virtbase));
+		break;
+
+	case VGA_TOP_WRITE_TILE_ANIM:
+		if (copy_from_user(&ta_arg, (vga_top_tile_anim_arg_t *) arg, sizeof(vga_top_tile_anim_arg_t)))
+			return -EACCES;
+		if (ta_arg.index >= NUM_TILE_ANIMS)
+			return -EINVAL;
+		iowrite32(((u32)(ta_arg.enable ? 1 : 0) << 31) | ((u32)ta_arg.frames << 16) |
+			  ((u32)ta_arg.vblanks << 8) | ta_arg.base,
+			  TILE_ANIM_REG(dev.virtbase, ta_arg.index));
+		break;
+
+	case VGA_TOP_WRITE_HAZARD_TILES:
+		if (copy_from_user(&hz_arg, (vga_top_hazard_tiles_arg_t *) arg, sizeof(vga_top_hazard_tiles_arg_t)))
+			return -EACCES;
+		for (i = 0; i < 8; i++)
+			iowrite32(hz_arg.mask[i], HAZARD_TILES_REG(dev.virtbase, i));
+		break;
+
+	case VGA_TOP_READ_COLLISION:
+		/* Words 0-3 hit, 4-7 hazard, then 4 per pair row */
+		for (i = 0; i < 4; i++) {
+			co_arg.hit[i] = ioread32(COLLISION_REG(dev.virtbase, i));
+			co_arg.hazard[i] = ioread32(COLLISION_REG(dev.virtbase, 4 + i));
+		}
+		for (i = 0; i < VGA_TOP_PAIR_ROWS * 4; i++)
+			co_arg.pairs[i / 4][i % 4] = ioread32(COLLISION_REG(dev.virtbase, 8 + i));
+		if (copy_to_user((vga_top_collision_arg_t *) arg, &co_arg, sizeof(vga_top_collision_arg_t)))
+			return -EACCES;
+		break;
+
+	case VGA_TOP_WRITE_COLQ_MAP:
+		/* Cells of the map size last written with the classes */
+		cm_user = (vga_top_colq_map_arg_t __user *) arg;
+		if (get_user(first, &cm_user->cell) || get_user(count, &cm_user->count))
+			return -EACCES;
+		v = ioread32(COLQ_BOUNDS_REG(dev.virtbase));
+		v = (v & 0xFF) * ((v >> 8) & 0xFF);
+		if (count > VGA_TOP_COLQ_MAP_CHUNK || first + count > v)
+			return -EINVAL;
+		iowrite32(first, COLQ_MAP_IDX_REG(dev.virtbase));
+		for (i = 0; i < count; i++) {
+			if (get_user(cls, &cm_user->classes[i]))
+				return -EACCES;
+			iowrite32(cls & 0xF, COLQ_MAP_DATA_REG(dev.virtbase));
+		}
+		break;
+
+	case VGA_TOP_WRITE_COLQ_CLASSES:
+		if (copy_from_user(&cc_arg, (vga_top_colq_classes_arg_t *) arg, sizeof(vga_top_colq_classes_arg_t)))
+			return -EACCES;
+		if (cc_arg.width * cc_arg.height > COLQ_MAP_ENTRIES)
+			return -EINVAL;
+		iowrite32(((u32)cc_arg.height << 8) | cc_arg.width, COLQ_BOUNDS_REG(dev.virtbase));
+		iowrite32(0, COLQ_PROFILE_IDX_REG(dev.virtbase));
+		for (i = 0; i < 256; i++)
+			iowrite32(cc_arg.profile[i / 16][i % 16], COLQ_PROFILE_DATA_REG(dev.virtbase));
+		for (i = 0, v = 0; i < 16; i++) {
+			v |= (u32)(cc_arg.hazard[i] & 0xF) << (4 * (i % 8));
+			if (i % 8 == 7) {
+				iowrite32(v, COLQ_HAZARD_REG(dev.virtbase, i / 8));
+				v = 0;
+			}
+		}
+		break;
+
+	case VGA_TOP_COLQ_QUERY:
+		/* The whole batch fits the query FIFO; wait for its last
+		 * result, a few clocks per tile each query crosses */
+		if (copy_from_user(&cq_arg, (vga_top_colq_arg_t *) arg, sizeof(vga_top_colq_arg_t)))
+			return -EACCES;
+		if (cq_arg.count > VGA_TOP_COLQ_BATCH)
+			return -EINVAL;
+		/* Drop anything a timed out batch left behind */
+		for (i = 0; i < COLQ_POLLS; i++)
+			if ((ioread32(COLQ_STATUS_REG(dev.virtbase)) & 0x3F) == 0)
+				break;
+		if (i == COLQ_POLLS)
+			return -EBUSY;
+		while ((ioread32(COLQ_STATUS_REG(dev.virtbase)) >> 8) & 0x1F)
+			ioread32(COLQ_RESULT_REG(dev.virtbase));
+		for (i = 0; i < cq_arg.count; i++)
+			iowrite32(cq_arg.query[i], COLQ_QUERY_REG(dev.virtbase));
+		for (i = 0; i < COLQ_POLLS; i++)
+			if (((ioread32(COLQ_STATUS_REG(dev.virtbase)) >> 8) & 0x1F) == cq_arg.count)
+				break;
+		if (i == COLQ_POLLS)
+			return -ETIMEDOUT;
+		for (i = 0; i < cq_arg.count; i++)
+			cq_arg.result[i] = ioread32(COLQ_RESULT_REG(dev.virtbase));
+		if (copy_to_user((vga_top_colq_arg_t *) arg, &cq_arg, sizeof(vga_top_colq_arg_t)))
+			return -EACCES;
+		break;
+
+	case VGA_TOP_WRITE_LINE_IRQ:
+		if (copy_from_user(&li_arg, (vga_top_line_irq_arg_t *) arg, sizeof(vga_top_line_irq_arg_t)))
+			return -EACCES;
+		if (li_arg.line >= VGA_TOP_VTOTAL)
+			return -EINVAL;
+		v = ioread32(LINE_IRQ_REG(dev.virtbase)) & VBLANK_IRQ_EN;
+		iowrite32(v | (li_arg.enable ? LINE_IRQ_EN : 0) | li_arg.line, LINE_IRQ_REG(dev.virtbase));
+		break;
+
+	case VGA_TOP_WAIT_EVENT:
+		/* Sleep until one of the events fires after the call */
+		if (copy_from_user(&ev_arg, (vga_top_event_arg_t *) arg, sizeof(vga_top_event_arg_t)))
+			return -EACCES;
+		if (!dev.irq)
+			return -ENODEV;
+		ev_arg.events &= VGA_TOP_EVENT_LINE | VGA_TOP_EVENT_VBLANK;
+		if (!ev_arg.events)
+			return -EINVAL;
+		seq[0] = READ_ONCE(dev.event_seq[0]);
+		seq[1] = READ_ONCE(dev.event_seq[1]);
+		ret = wait_event_interruptible_timeout(dev.event_wq, vga_top_fired(seq, ev_arg.events), HZ / 10);
+		if (ret < 0)
+			return ret;
+		if (ret == 0)
+			return -ETIMEDOUT;
+		ev_arg.events = vga_top_fired(seq, ev_arg.events);
+		ev_arg.frame_count = READ_ONCE(dev.event_frame[(ev_arg.events & VGA_TOP_EVENT_LINE) ? 0 : 1]);
+		if (copy_to_user((vga_top_event_arg_t *) arg, &ev_arg, sizeof(vga_top_event_arg_t)))
+			return -EACCES;
+		break;
+
+	case VGA_TOP_READ_TEAR:
+		/* Words 0-3 unsafe, 4-7 active, 8 the counts */
+		te_arg.frame_count = ioread32(FRAME_COUNT_REG(dev.virtbase));
+		for (i = 0; i < 4; i++) {
+			te_arg.unsafe[i] = ioread32(TEAR_LOG_REG(dev.virtbase, i));
+			te_arg.active[i] = ioread32(TEAR_LOG_REG(dev.virtbase, 4 + i));
+		}
+		v = ioread32(TEAR_LOG_REG(dev.virtbase, 8));
+		te_arg.active_writes = v >> 16;
+		te_arg.unsafe_writes = v & 0xFFFF;
+		if (copy_to_user((vga_top_tear_arg_t *) arg, &te_arg, sizeof(vga_top_tear_arg_t)))
+			return -EACCES;
+		break;
+
 	default:
 		return -EINVAL;
 	}
@@ -123,6 +603,17 @@ static int __init vga_top_probe(struct platform_device *pdev)
 		ret = -ENOMEM;
 		goto out_release_mem_region;
 	}
+
+	/* Raster events; without the interrupt the rest still works and
+	 * VGA_TOP_WAIT_EVENT reports -ENODEV */
+	init_waitqueue_head(&dev.event_wq);
+	dev.irq = irq_of_parse_and_map(pdev->dev.of_node, 0);
+	if (dev.irq > 0 && request_irq(dev.irq, vga_top_irq, 0, DRIVER_NAME, &dev) == 0) {
+		iowrite32(0x3, IRQ_PENDING_REG(dev.virtbase));
+		iowrite32(VBLANK_IRQ_EN, LINE_IRQ_REG(dev.virtbase));
+	} else {
+		dev.irq = 0;
+	}
         
 	return 0;
 
@@ -136,6 +627,10 @@ out_deregister:
 /* Clean-up code: release resources */
 static int vga_top_remove(struct platform_device *pdev)
 {
+	if (dev.irq) {
+		iowrite32(0, LINE_IRQ_REG(dev.virtbase));
+		free_irq(dev.irq, &dev);
+	}
 	iounmap(dev.virtbase);
 	release_mem_region(dev.res.start, resource_size(&dev.res));
 	misc_deregister(&vga_top_misc_device);
@@ -0,0 +1,109 @@
+/*
+Clock domain crossings between the 50 MHz bus clock and the render clock.
+
+cdc_sync  : two flops for a level, or a bus of levels that only changes
+            while nothing reads it
+cdc_pulse : a one-clock pulse in src_clk becomes a one-clock pulse in
+            dst_clk. Pulses must be at least 3 dst_clk clocks apart.
+cdc_fifo  : DEPTH-entry FIFO with gray-coded pointers. wr_full and rd_empty
+            are pessimistic by the two clocks the other side's pointer takes
+            to arrive; a write while wr_full is lost.
+*/
+module cdc_sync #(
+    parameter W = 1
+)(
+    input  logic         clk,
+    input  logic [W-1:0] d,
+    output logic [W-1:0] q
+);
+    logic [W-1:0] meta;
+
+    always_ff @(posedge clk) begin
+        meta <= d;
+        q    <= meta;
+    end
+endmodule
+
+module cdc_pulse(
+    input  logic src_clk,
+    input  logic src_reset,
+    input  logic src_pulse,
+    input  logic dst_clk,
+    output logic dst_pulse
+);
+    logic toggle, toggle_s, toggle_d;
+
+    always_ff @(posedge src_clk)
+        if (src_reset)
+            toggle <= 0;
+        else if (src_pulse)
+            toggle <= ~toggle;
+
+    cdc_sync u_sync(.clk(dst_clk), .d(toggle), .q(toggle_s));
+
+    always_ff @(posedge dst_clk)
+        toggle_d <= toggle_s;
+
+    assign dst_pulse = toggle_s != toggle_d;
+endmodule
+
+module cdc_fifo #(
+    parameter W     = 32,
+    parameter DEPTH = 16
+)(
+    input  logic         wr_clk,
+    input  logic         wr_reset,
+    input  logic         wr_en,
+    input  logic [W-1:0] wr_data,
+    output logic         wr_full,
+
+    input  logic         rd_clk,
+    input  logic         rd_reset,
+    input  logic         rd_en,
+    output logic [W-1:0] rd_data,
+    output logic         rd_empty
+);
+    localparam int AW = $clog2(DEPTH);
+
+    logic [W-1:0] mem [DEPTH];
+    logic [AW:0]  wr_bin, wr_gray, rd_bin, rd_gray;
+    logic [AW:0]  wr_gray_s, rd_gray_s;     // the other side's pointer
+    logic [AW:0]  wr_bin_next, rd_bin_next;
+
+    function automatic logic [AW:0] to_gray(input logic [AW:0] b);
+        to_gray = b ^ (b >> 1);
+    endfunction
+
+    assign wr_bin_next = wr_bin + (wr_en && !wr_full);
+    assign rd_bin_next = rd_bin + (rd_en && !rd_empty);
+
+    always_ff @(posedge wr_clk) begin
+        if (wr_en && !wr_full)
+            mem[wr_bin[AW-1:0]] <= wr_data;
+        if (wr_reset) begin
+            wr_bin  <= 0;
+            wr_gray <= 0;
+        end else begin
+            wr_bin  <= wr_bin_next;
+            wr_gray <= to_gray(wr_bin_next);
+        end
+    end
+
+    always_ff @(posedge rd_clk) begin
+        if (rd_reset) begin
+            rd_bin  <= 0;
+            rd_gray <= 0;
+        end else begin
+            rd_bin  <= rd_bin_next;
+            rd_gray <= to_gray(rd_bin_next);
+        end
+    end
+
+    cdc_sync #(.W(AW + 1)) u_rd_to_wr(.clk(wr_clk), .d(rd_gray), .q(rd_gray_s));
+    cdc_sync #(.W(AW + 1)) u_wr_to_rd(.clk(rd_clk), .d(wr_gray), .q(wr_gray_s));
+
+    // Full: the pointers differ in their top two gray bits only
+    assign wr_full  = wr_gray == {~rd_gray_s[AW:AW-1], rd_gray_s[AW-2:0]};
+    assign rd_empty = rd_gray == wr_gray_s;
+    assign rd_data  = mem[rd_bin[AW-1:0]];
+endmodule
@@ -0,0 +1,186 @@
+/*
+Collision query unit: the terrain probe of the game's tile collision,
+answered in hardware for a batch of boxes.
+
+A query is one word: [31:26] h, [25:20] w, [19:10] y, [9:0] x. It probes
+the column x + w / 2 over the rows y .. y + h - 1 of a map_w x map_h tile
+map, the same single column the software collision walks. Each map cell
+holds a 4-bit class (map_wr_*, cell row * map_w + col); each class has a
+16 x 16 blocked profile, one 16-bit word per pixel column of the tile with
+bit r set when row r blocks (prof_wr_*, address {class, column}), and 4
+hazard bits (hazard_wr_*, class c in bits 4c+3:4c of word c / 8).
+
+Result word: [30] blocked, [19:16] hazard, [10:0] surface. blocked is set
+when a probed row hits a blocked profile bit or lies outside the map, and
+surface is the first such row. hazard ORs the hazard bits of every class
+the probe touches, up to the first row outside the map. A query with h = 0
+answers not blocked.
+
+Queries wait in a DEPTH-deep FIFO and results in another; r_data shows the
+oldest result with bit 31 set, or 0 when there is none, and r_pop drops it.
+A push to a full query FIFO is lost. The probe takes 3 clocks per tile
+row it crosses.
+*/
+module collision_query #(
+    parameter DEPTH = 16
+)(
+    input  logic        clk,
+    input  logic        reset,
+
+    input  logic        map_wr_en,
+    input  logic [12:0] map_wr_addr,
+    input  logic [3:0]  map_wr_data,
+    input  logic        prof_wr_en,
+    input  logic [7:0]  prof_wr_addr,
+    input  logic [15:0] prof_wr_data,
+    input  logic        hazard_wr_en,
+    input  logic        hazard_wr_idx,
+    input  logic [31:0] hazard_wr_data,
+    input  logic [7:0]  map_w,              // tiles
+    input  logic [7:0]  map_h,
+
+    input  logic        q_push,
+    input  logic [31:0] q_data,
+    input  logic        r_pop,
+    output logic [31:0] r_data,
+    output logic [$clog2(DEPTH)+1:0] q_pending,  // queued or being probed
+    output logic [$clog2(DEPTH):0]   r_count
+);
+
+    localparam int AW = $clog2(DEPTH);
+
+    logic [3:0]  class_map [8192];
+    logic [15:0] profile   [256];
+    logic [63:0] hazard_bits;
+    logic [3:0]  map_q;
+    logic [15:0] prof_q;
+
+    logic [31:0] qf [DEPTH];
+    logic [AW-1:0] qf_rd, qf_wr;
+    logic [AW:0]   qf_cnt;
+    logic [30:0] rf [DEPTH];
+    logic [AW-1:0] rf_rd, rf_wr;
+    logic [AW:0]   rf_cnt;
+
+    typedef enum logic [2:0] {S_IDLE, S_MAP, S_CLASS, S_PROF, S_DONE} state_t;
+    state_t state;
+
+    logic [10:0] cx;                        // probe column
+    logic [10:0] cy;                        // first row left in this tile
+    logic [10:0] y_last;
+    logic        blocked;
+    logic [10:0] surface;
+    logic [3:0]  hazard;
+
+    logic        q_take, r_put;
+    logic [31:0] q_head;
+    logic        outside;
+    logic [12:0] map_ra;
+    logic [15:0] rows, hits;
+    logic [3:0]  first_hit;
+
+    assign q_head  = qf[qf_rd];
+    assign q_take  = state == S_IDLE && qf_cnt != 0 && rf_cnt < DEPTH;
+    assign r_put   = state == S_DONE;
+    assign outside = {1'b0, cx[10:4]} >= map_w || {1'b0, cy[10:4]} >= map_h;
+    assign map_ra  = cy[10:4] * map_w + cx[10:4];
+
+    // Rows of this tile inside the query, and the blocked ones among them
+    always_comb begin
+        rows = 16'hFFFF << cy[3:0];
+        if (cy[10:4] == y_last[10:4])
+            rows = rows & (16'hFFFF >> (4'd15 - y_last[3:0]));
+        hits = prof_q & rows;
+        first_hit = 0;
+        for (int r = 15; r >= 0; r--)
+            if (hits[r])
+                first_hit = 4'(r);
+    end
+
+    always_ff @(posedge clk) begin
+        map_q  <= class_map[map_ra];
+        prof_q <= profile[{map_q, cx[3:0]}];
+        if (map_wr_en)
+            class_map[map_wr_addr] <= map_wr_data;
+        if (prof_wr_en)
+            profile[prof_wr_addr] <= prof_wr_data;
+        if (q_push && qf_cnt < DEPTH)
+            qf[qf_wr] <= q_data;
+        if (r_put)
+            rf[rf_wr] <= {blocked, 10'd0, hazard, 5'd0, surface};
+    end
+
+    always_ff @(posedge clk) begin
+        if (reset) begin
+            hazard_bits <= '0;
+            qf_rd  <= 0;
+            qf_wr  <= 0;
+            qf_cnt <= 0;
+            rf_rd  <= 0;
+            rf_wr  <= 0;
+            rf_cnt <= 0;
+            state  <= S_IDLE;
+        end
+        else begin
+            if (hazard_wr_en)
+                hazard_bits[32*hazard_wr_idx +: 32] <= hazard_wr_data;
+
+            if (q_push && qf_cnt < DEPTH)
+                qf_wr <= qf_wr + 1'b1;
+            if (q_take)
+                qf_rd <= qf_rd + 1'b1;
+            qf_cnt <= qf_cnt + (q_push && qf_cnt < DEPTH) - q_take;
+
+            if (r_put)
+                rf_wr <= rf_wr + 1'b1;
+            if (r_pop && rf_cnt != 0)
+                rf_rd <= rf_rd + 1'b1;
+            rf_cnt <= rf_cnt + r_put - (r_pop && rf_cnt != 0);
+
+            case (state)
+                S_IDLE: if (q_take) begin
+                    cx      <= q_head[9:0] + q_head[25:21];
+                    cy      <= {1'b0, q_head[19:10]};
+                    y_last  <= q_head[19:10] + q_head[31:26] - 1'b1;
+                    blocked <= 0;
+                    surface <= 0;
+                    hazard  <= 0;
+                    state   <= q_head[31:26] == 0 ? S_DONE : S_MAP;
+                end
+                // map_q is read this clock
+                S_MAP: begin
+                    if (outside) begin
+                        if (!blocked)
+                            surface <= cy;
+                        blocked <= 1;
+                        state   <= S_DONE;
+                    end
+                    else
+                        state <= S_CLASS;
+                end
+                // prof_q is read this clock
+                S_CLASS: begin
+                    hazard <= hazard | hazard_bits[4*map_q +: 4];
+                    state  <= S_PROF;
+                end
+                S_PROF: begin
+                    if (hits != 0 && !blocked) begin
+                        blocked <= 1;
+                        surface <= {cy[10:4], first_hit};
+                    end
+                    if (cy[10:4] == y_last[10:4])
+                        state <= S_DONE;
+                    else begin
+                        cy    <= {cy[10:4] + 1'b1, 4'd0};
+                        state <= S_MAP;
+                    end
+                end
+                S_DONE: state <= S_IDLE;
+                default: state <= S_IDLE;
+            endcase
+        end
+    end
+
+    assign r_data    = rf_cnt != 0 ? {1'b1, rf[rf_rd]} : 32'd0;
+    assign q_pending = qf_cnt + (state != S_IDLE);
+endmodule
@@ -1,69 +1,95 @@
+// Two line buffers: the render side draws one line into one while the
+// display reads the other, and "switch" swaps them. Drawing runs on
+// clk_draw and the display on clk_disp; each RAM takes its writes on the
+// first and its reads on the second. A line is 41 tile words (656 pixels),
+// so the display can read up to 15 pixels past 640 when fine_x shifts
+// the line right.
 module linebuffer(
-    input logic clk,
-    input logic reset,
-    input logic switch,
-    input logic [5:0] addr_tile_disp,
+    input logic clk_draw,
+    input logic clk_disp,
+    input logic reset,                        // clk_disp
+    input logic switch,                       // clk_disp; toggled between lines
     input logic [9:0] addr_pixel_disp,
     input logic [5:0] addr_tile_draw,
-    input logic [9:0] addr_pixel_draw,
+    input logic [7:0] addr_pixel_draw,        // 4-pixel group
 
     // indata
-    input logic [255:0] data_tile_disp,
-    input logic [15:0]  data_pixel_disp,
     input logic [255:0] data_tile_draw,
-    input logic [15:0]  data_pixel_draw,
+    input logic [63:0]  data_pixel_draw,      // pixel 0 in [15:0]
+    input logic [7:0]   byteena_pixel_draw,   // 2 bits per pixel
 
     // wren
-    input logic wren_tile_disp,
-    input logic wren_pixel_disp,
     input logic wren_tile_draw,
     input logic wren_pixel_draw,
 
     // outdata
-    output logic [255:0] q_tile_disp,
-    output logic [15:0]  q_pixel_disp,
-    output logic [255:0] q_tile_draw,
-    output logic [15:0]  q_pixel_draw
+    output logic [15:0]  q_pixel_disp
 );
 
-    logic [5:0] addr_tile[1:0];
-    logic [9:0] addr_pixel[1:0];
+    // Tiles and sprite pixels share the write port. A sprite group lands
+    // in its quarter of the 16-pixel tile word under its byte enables.
+    // The tile engine's background pass is over before the sprites start,
+    // so the two never write at once.
+    logic [5:0]   wr_addr;
+    logic [255:0] wr_data;
+    logic [31:0]  wr_be;
+    logic         wren[1:0];
+    logic [63:0]  q_pixel[1:0];
 
-    logic [255:0] data_tile[1:0];
-    logic [15:0]  data_pixel[1:0];
+    always_comb begin
+        if (wren_pixel_draw) begin
+            wr_addr = addr_pixel_draw[7:2];
+            wr_data = {4{data_pixel_draw}};
+            wr_be   = {24'd0, byteena_pixel_draw} << {addr_pixel_draw[1:0], 3'b0};
+        end else begin
+            wr_addr = addr_tile_draw;
+            wr_data = data_tile_draw;
+            wr_be   = '1;
+        end
+    end
+
+    // The swap reaches the draw side through a synchronizer. The next line
+    // starts drawing well after the switch toggles, once its start has
+    // crossed over as well.
+    logic draw_sel;
+
+    cdc_sync u_switch_sync(.clk(clk_draw), .d(switch), .q(draw_sel));
+
+    assign wren[0] = (wren_tile_draw || wren_pixel_draw) && !draw_sel;
+    assign wren[1] = (wren_tile_draw || wren_pixel_draw) && draw_sel;
 
-    logic wren_tile[1:0];
-    logic wren_pixel[1:0];
+    // The display works one pixel at a time: it addresses the 4-pixel
+    // group and picks the pixel out of the word, which arrives one clock
+    // after the address.
+    logic [1:0] disp_sel_pixel;
+    logic       disp_sel;
+
+    always_ff @(posedge clk_disp)
+        disp_sel_pixel <= addr_pixel_disp[1:0];
 
-    logic [255:0] q_tile[1:0];
-    logic [15:0]  q_pixel[1:0];
-    
     linebuffer_ram linebuffer_ram0(
-        .address_a 	(addr_tile[0] ),
-        .address_b 	(addr_pixel[0] ),
-        .clock     	(clk      ),
-        .data_a    	(data_tile[0] ),
-        .data_b    	(data_pixel[0] ),
-        .wren_a    	(wren_tile[0]  ),
-        .wren_b    	(wren_pixel[0] ),
-        .q_a       	(q_tile[0]     ),
-        .q_b       	(q_pixel[0]     )
+        .byteena_a 	(wr_be      ),
+        .data      	(wr_data    ),
+        .rdaddress 	(addr_pixel_disp[9:2]),
+        .rdclock   	(clk_disp   ),
+        .wraddress 	(wr_addr    ),
+        .wrclock   	(clk_draw   ),
+        .wren      	(wren[0]    ),
+        .q         	(q_pixel[0] )
     );
 
     linebuffer_ram linebuffer_ram1(
-        .address_a 	(addr_tile[1] ),
-        .address_b 	(addr_pixel[1] ),
-        .clock     	(clk      ),
-        .data_a    	(data_tile[1] ),
-        .data_b    	(data_pixel[1] ),
-        .wren_a    	(wren_tile[1]  ),
-        .wren_b    	(wren_pixel[1] ),
-        .q_a       	(q_tile[1]     ),
-        .q_b       	(q_pixel[1]     )
+        .byteena_a 	(wr_be      ),
+        .data      	(wr_data    ),
+        .rdaddress 	(addr_pixel_disp[9:2]),
+        .rdclock   	(clk_disp   ),
+        .wraddress 	(wr_addr    ),
+        .wrclock   	(clk_draw   ),
+        .wren      	(wren[1]    ),
+        .q         	(q_pixel[1] )
     );
-    logic disp_sel;
 
-    always_ff @(posedge clk) begin
+    always_ff @(posedge clk_disp) begin
         if (reset) begin
             disp_sel <= 0;
         end else begin
@@ -71,46 +97,9 @@ module linebuffer(
         end
     end
 
-    always_comb begin
-        if (disp_sel) begin
-            // RAM0 disp, RAM1 draw
-            addr_tile[0] = addr_tile_disp;
-            addr_pixel[0] = addr_pixel_disp;
-            data_tile[0] = data_tile_disp;
-            data_pixel[0] = data_pixel_disp;
-            wren_tile[0] = wren_tile_disp;
-            wren_pixel[0] = wren_pixel_disp;
-            q_tile_disp =  q_tile[0];
-            q_pixel_disp = q_pixel[0];
-
-            addr_tile[1] = addr_tile_draw;
-            addr_pixel[1] = addr_pixel_draw;
-            data_tile[1] = data_tile_draw;
-            data_pixel[1] = data_pixel_draw;
-            wren_tile[1] = wren_tile_draw;
-            wren_pixel[1] = wren_pixel_draw;
-            q_tile_draw =  q_tile[1];
-            q_pixel_draw = q_pixel[1];
-        end else begin
-            // RAM0 draw, RAM1 disp
-            addr_tile[1] = addr_tile_disp;
-            addr_pixel[1] = addr_pixel_disp;
-            data_tile[1] = data_tile_disp;
-            data_pixel[1] = data_pixel_disp;
-            wren_tile[1] = wren_tile_disp;
-            wren_pixel[1] = wren_pixel_disp;
-            q_tile_disp =  q_tile[1];
-            q_pixel_disp = q_pixel[1];
+    // disp_sel = 1: RAM0 disp, RAM1 draw
+    logic [63:0] q_pixel_disp_w;
+    assign q_pixel_disp_w = disp_sel ? q_pixel[0] : q_pixel[1];
+    assign q_pixel_disp   = q_pixel_disp_w[{disp_sel_pixel, 4'b0} +: 16];
 
-            addr_tile[0] = addr_tile_draw;
-            addr_pixel[0] = addr_pixel_draw;
-            data_tile[0] = data_tile_draw;
-            data_pixel[0] = data_pixel_draw;
-            wren_tile[0] = wren_tile_draw;
-            wren_pixel[0] = wren_pixel_draw;
-            q_tile_draw =  q_tile[0];
-            q_pixel_draw = q_pixel[0];
-        end
-    end
-    
-endmodule
\ No newline at end of file
+endmodule
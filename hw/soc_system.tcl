@@ -396,6 +396,12 @@ puts $sdcf {
 
     derive_pll_clocks -create_base_clocks
     derive_clock_uncertainty
+
+    # vga_top's render clock meets clock_50_1 only through the crossings
+    # in cdc.sv and registers that hold still while the other side reads
+    set_clock_groups -asynchronous \
+	-group [get_clocks clock_50_1] \
+	-group [get_clocks {*u_render_pll*}]
 }
 close $sdcf
 
@@ -0,0 +1,152 @@
+/*
+Per-sprite frame animation.
+
+Each sprite has an animation word next to its attribute word:
+
+[31]    : Enable = 1, the attribute frame_id is ignored
+[30]    : Ping-pong = 1 (0 1 2 1 0 ...), wrap = 0 (0 1 2 0 1 ...)
+[29]    : Motion link = 1, x/y are relative to the motion channel
+[28:25] : Motion channel (see sprite_motion)
+[24]    : Reserved
+[23:16] : Base frame
+[15:8]  : Frame count (0 and 1 don't animate)
+[7:0]   : Vblanks per step (0 steps every vblank)
+
+Once per frame (frame_tick) the table is walked LANES entries per clock and
+every enabled sprite's step is advanced. Writing an animation word restarts
+that sprite at step 0. During display the configuration and step are read
+with the same address and latency as the attribute RAM, so sprite_eval sees
+them beside the attribute words. The step counts whole sprites; sprite_eval
+scales it by the frames per sprite of the sprite's size.
+*/
+module sprite_anim #(
+    parameter NUM_SPRITE = 128,
+    parameter LANES      = 4
+)(
+    input  logic           clk,
+    input  logic           reset,
+
+    input  logic                            wr_en,
+    input  logic [$clog2(NUM_SPRITE)-1:0]   wr_idx,
+    input  logic [31:0]                     wr_data,
+
+    input  logic           frame_tick,      // start of vblank
+    output logic           busy,
+
+    // read side, driven by sprite_eval outside busy
+    input  logic [$clog2(NUM_SPRITE/LANES)-1:0] ra,
+    output logic [LANES-1:0]                    anim_en,
+    output logic [8*LANES-1:0]                  anim_base,
+    output logic [8*LANES-1:0]                  anim_step,
+    output logic [LANES-1:0]                    link_en,
+    output logic [4*LANES-1:0]                  link_chan
+);
+
+    localparam int WORDS = NUM_SPRITE / LANES;
+    localparam int WW    = $clog2(WORDS);
+
+    logic [32*LANES-1:0] cfg_rd;
+    logic [WW-1:0]       cfg_ra;
+
+    // Same mixed-width RAM as the attribute table
+    sprite_attr_ram u_cfg (
+        .clock     (clk),
+        .data      (wr_data),
+        .rdaddress (cfg_ra),
+        .wraddress (wr_idx),
+        .wren      (wr_en),
+        .q         (cfg_rd)
+    );
+
+    logic [7:0] step [NUM_SPRITE];
+    logic [7:0] tick [NUM_SPRITE];
+    logic       dir  [NUM_SPRITE];          // ping-pong: 1 = counting down
+
+    logic [WW-1:0] word, word_d;
+    logic          rd_valid;
+
+    assign cfg_ra = busy ? word : ra;
+
+    // Step read with the RAM's one-clock latency
+    always_ff @(posedge clk)
+        for (int l = 0; l < LANES; l++)
+            anim_step[8*l +: 8] <= step[ra*LANES + l];
+
+    always_comb
+        for (int l = 0; l < LANES; l++) begin
+            anim_en[l]          = cfg_rd[32*l+31];
+            anim_base[8*l +: 8] = cfg_rd[32*l+16 +: 8];
+            link_en[l]          = cfg_rd[32*l+29];
+            link_chan[4*l +: 4] = cfg_rd[32*l+25 +: 4];
+        end
+
+    always_ff @(posedge clk) begin
+        if (reset) begin
+            busy     <= 0;
+            word     <= 0;
+            word_d   <= 0;
+            rd_valid <= 0;
+            for (int i = 0; i < NUM_SPRITE; i++) begin
+                step[i] <= 0;
+                tick[i] <= 0;
+                dir[i]  <= 0;
+            end
+        end
+        else begin
+            if (frame_tick) begin
+                busy <= 1;
+                word <= 0;
+            end else if (busy) begin
+                if (word == WORDS - 1)
+                    busy <= 0;
+                else
+                    word <= word + 1'b1;
+            end
+            rd_valid <= busy;
+            word_d   <= word;
+
+            if (rd_valid) begin
+                for (int l = 0; l < LANES; l++) begin
+                    automatic int         i      = word_d * LANES + l;
+                    automatic logic [31:0] c     = cfg_rd[32*l +: 32];
+                    automatic logic [7:0]  count = c[15:8];
+
+                    if (!c[31] || count <= 8'd1) begin
+                        step[i] <= 0;
+                        tick[i] <= 0;
+                        dir[i]  <= 0;
+                    end
+                    else if (tick[i] + 9'd1 < {1'b0, c[7:0]}) begin
+                        tick[i] <= tick[i] + 1'b1;
+                    end
+                    else begin
+                        tick[i] <= 0;
+                        if (!c[30])
+                            step[i] <= (step[i] + 9'd1 >= {1'b0, count}) ? 8'd0 : step[i] + 1'b1;
+                        else if (!dir[i]) begin
+                            if (step[i] + 9'd1 >= {1'b0, count}) begin
+                                dir[i]  <= 1;
+                                step[i] <= step[i] - 1'b1;
+                            end else
+                                step[i] <= step[i] + 1'b1;
+                        end
+                        else begin
+                            if (step[i] == 0) begin
+                                dir[i]  <= 0;
+                                step[i] <= 8'd1;
+                            end else
+                                step[i] <= step[i] - 1'b1;
+                        end
+                    end
+                end
+            end
+
+            // A new configuration restarts its sprite
+            if (wr_en) begin
+                step[wr_idx] <= 0;
+                tick[wr_idx] <= 0;
+                dir[wr_idx]  <= 0;
+            end
+        end
+    end
+endmodule
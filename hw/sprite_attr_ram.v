@@ -34,9 +34,11 @@
 //https://fpgasoftware.intel.com/eula.
 
 /*
-80 to ff address (byte address)
-1000 0000 to 1111 1111
-0010 0000 to 0011 1111 (word address)
+200 to 3fc address (byte address)
+1000 0000 to 1111 1111 (word address)
+
+Mixed width: written one 32-bit entry at a time, read four entries
+(128 bits) at a time. Entry 4w+k is bits [32k+31:32k] of read word w.
 */
 
 // synopsys translate_off
@@ -53,9 +55,9 @@ module sprite_attr_ram (
 	input	  clock;
 	input	[31:0]  data;
 	input	[4:0]  rdaddress;
-	input	[4:0]  wraddress;
+	input	[6:0]  wraddress;
 	input	  wren;
-	output	[31:0]  q;
+	output	[127:0]  q;
 `ifndef ALTERA_RESERVED_QIS
 // synopsys translate_off
 `endif
@@ -65,8 +67,8 @@ module sprite_attr_ram (
 // synopsys translate_on
 `endif
 
-	wire [31:0] sub_wire0;
-	wire [31:0] q = sub_wire0[31:0];
+	wire [127:0] sub_wire0;
+	wire [127:0] q = sub_wire0[127:0];
 
 	altsyncram	altsyncram_component (
 				.address_a (wraddress),
@@ -86,7 +88,7 @@ module sprite_attr_ram (
 				.clocken1 (1'b1),
 				.clocken2 (1'b1),
 				.clocken3 (1'b1),
-				.data_b ({32{1'b1}}),
+				.data_b ({128{1'b1}}),
 				.eccstatus (),
 				.q_a (),
 				.rden_a (1'b1),
@@ -100,17 +102,17 @@ module sprite_attr_ram (
 		altsyncram_component.clock_enable_output_b = "BYPASS",
 		altsyncram_component.intended_device_family = "Cyclone V",
 		altsyncram_component.lpm_type = "altsyncram",
-		altsyncram_component.numwords_a = 32,
+		altsyncram_component.numwords_a = 128,
 		altsyncram_component.numwords_b = 32,
 		altsyncram_component.operation_mode = "DUAL_PORT",
 		altsyncram_component.outdata_aclr_b = "NONE",
 		altsyncram_component.outdata_reg_b = "UNREGISTERED",
 		altsyncram_component.power_up_uninitialized = "FALSE",
 		altsyncram_component.read_during_write_mode_mixed_ports = "DONT_CARE",
-		altsyncram_component.widthad_a = 5,
+		altsyncram_component.widthad_a = 7,
 		altsyncram_component.widthad_b = 5,
 		altsyncram_component.width_a = 32,
-		altsyncram_component.width_b = 32,
+		altsyncram_component.width_b = 128,
 		altsyncram_component.width_byteena_a = 1;
 
 
@@ -149,7 +151,7 @@ endmodule
 // Retrieval info: PRIVATE: JTAG_ENABLED NUMERIC "0"
 // Retrieval info: PRIVATE: JTAG_ID STRING "NONE"
 // Retrieval info: PRIVATE: MAXIMUM_DEPTH NUMERIC "0"
-// Retrieval info: PRIVATE: MEMSIZE NUMERIC "1024"
+// Retrieval info: PRIVATE: MEMSIZE NUMERIC "4096"
 // Retrieval info: PRIVATE: MEM_IN_BITS NUMERIC "0"
 // Retrieval info: PRIVATE: MIFfilename STRING ""
 // Retrieval info: PRIVATE: OPERATION_MODE NUMERIC "2"
@@ -168,9 +170,9 @@ endmodule
 // Retrieval info: PRIVATE: SYNTH_WRAPPER_GEN_POSTFIX STRING "0"
 // Retrieval info: PRIVATE: USE_DIFF_CLKEN NUMERIC "0"
 // Retrieval info: PRIVATE: UseDPRAM NUMERIC "1"
-// Retrieval info: PRIVATE: VarWidth NUMERIC "0"
-// Retrieval info: PRIVATE: WIDTH_READ_A NUMERIC "32"
-// Retrieval info: PRIVATE: WIDTH_READ_B NUMERIC "32"
+// Retrieval info: PRIVATE: VarWidth NUMERIC "1"
+// Retrieval info: PRIVATE: WIDTH_READ_A NUMERIC "128"
+// Retrieval info: PRIVATE: WIDTH_READ_B NUMERIC "128"
 // Retrieval info: PRIVATE: WIDTH_WRITE_A NUMERIC "32"
 // Retrieval info: PRIVATE: WIDTH_WRITE_B NUMERIC "32"
 // Retrieval info: PRIVATE: WRADDR_ACLR_B NUMERIC "0"
@@ -186,30 +188,30 @@ endmodule
 // Retrieval info: CONSTANT: CLOCK_ENABLE_OUTPUT_B STRING "BYPASS"
 // Retrieval info: CONSTANT: INTENDED_DEVICE_FAMILY STRING "Cyclone V"
 // Retrieval info: CONSTANT: LPM_TYPE STRING "altsyncram"
-// Retrieval info: CONSTANT: NUMWORDS_A NUMERIC "32"
+// Retrieval info: CONSTANT: NUMWORDS_A NUMERIC "128"
 // Retrieval info: CONSTANT: NUMWORDS_B NUMERIC "32"
 // Retrieval info: CONSTANT: OPERATION_MODE STRING "DUAL_PORT"
 // Retrieval info: CONSTANT: OUTDATA_ACLR_B STRING "NONE"
 // Retrieval info: CONSTANT: OUTDATA_REG_B STRING "UNREGISTERED"
 // Retrieval info: CONSTANT: POWER_UP_UNINITIALIZED STRING "FALSE"
 // Retrieval info: CONSTANT: READ_DURING_WRITE_MODE_MIXED_PORTS STRING "DONT_CARE"
-// Retrieval info: CONSTANT: WIDTHAD_A NUMERIC "5"
+// Retrieval info: CONSTANT: WIDTHAD_A NUMERIC "7"
 // Retrieval info: CONSTANT: WIDTHAD_B NUMERIC "5"
 // Retrieval info: CONSTANT: WIDTH_A NUMERIC "32"
-// Retrieval info: CONSTANT: WIDTH_B NUMERIC "32"
+// Retrieval info: CONSTANT: WIDTH_B NUMERIC "128"
 // Retrieval info: CONSTANT: WIDTH_BYTEENA_A NUMERIC "1"
 // Retrieval info: USED_PORT: clock 0 0 0 0 INPUT VCC "clock"
 // Retrieval info: USED_PORT: data 0 0 32 0 INPUT NODEFVAL "data[31..0]"
-// Retrieval info: USED_PORT: q 0 0 32 0 OUTPUT NODEFVAL "q[31..0]"
+// Retrieval info: USED_PORT: q 0 0 128 0 OUTPUT NODEFVAL "q[127..0]"
 // Retrieval info: USED_PORT: rdaddress 0 0 5 0 INPUT NODEFVAL "rdaddress[4..0]"
-// Retrieval info: USED_PORT: wraddress 0 0 5 0 INPUT NODEFVAL "wraddress[4..0]"
+// Retrieval info: USED_PORT: wraddress 0 0 7 0 INPUT NODEFVAL "wraddress[6..0]"
 // Retrieval info: USED_PORT: wren 0 0 0 0 INPUT GND "wren"
-// Retrieval info: CONNECT: @address_a 0 0 5 0 wraddress 0 0 5 0
+// Retrieval info: CONNECT: @address_a 0 0 7 0 wraddress 0 0 7 0
 // Retrieval info: CONNECT: @address_b 0 0 5 0 rdaddress 0 0 5 0
 // Retrieval info: CONNECT: @clock0 0 0 0 0 clock 0 0 0 0
 // Retrieval info: CONNECT: @data_a 0 0 32 0 data 0 0 32 0
 // Retrieval info: CONNECT: @wren_a 0 0 0 0 wren 0 0 0 0
-// Retrieval info: CONNECT: q 0 0 32 0 @q_b 0 0 32 0
+// Retrieval info: CONNECT: q 0 0 128 0 @q_b 0 0 128 0
 // Retrieval info: GEN_FILE: TYPE_NORMAL sprite_attr_ram.v TRUE
 // Retrieval info: GEN_FILE: TYPE_NORMAL sprite_attr_ram.inc FALSE
 // Retrieval info: GEN_FILE: TYPE_NORMAL sprite_attr_ram.cmp FALSE
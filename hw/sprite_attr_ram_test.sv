@@ -1,15 +1,24 @@
+// Behavioural stand-in for the sprite_attr_ram IP, for simulation without
+// the Altera libraries. Same ports: 32-bit writes, 128-bit (4-entry) reads
+// with a registered read address.
 module sprite_attr_ram #(
-    parameter NUM_SPRITE = 32
+    parameter NUM_SPRITE = 128,
+    parameter LANES      = 4
 )(
-    input logic clk,
-    input logic [$clog2(NUM_SPRITE)-1:0] ra,
-    input logic [$clog2(NUM_SPRITE)-1:0] wa,
-    input logic write,
-    input logic [31:0] d,
-    output logic [31:0] q);
+    input  logic clock,
+    input  logic [31:0] data,
+    input  logic [$clog2(NUM_SPRITE/LANES)-1:0] rdaddress,
+    input  logic [$clog2(NUM_SPRITE)-1:0] wraddress,
+    input  logic wren,
+    output logic [32*LANES-1:0] q);
     logic [31:0] mem [NUM_SPRITE];
-    always_ff @(posedge clk) begin
-    if (write) mem[wa] <= d;
-        q <= mem[ra];
+    logic [$clog2(NUM_SPRITE/LANES)-1:0] ra_q;
+    initial for (int i = 0; i < NUM_SPRITE; i++) mem[i] = 0;
+    always_ff @(posedge clock) begin
+        if (wren) mem[wraddress] <= data;
+        ra_q <= rdaddress;
     end
+    always_comb
+        for (int l = 0; l < LANES; l++)
+            q[32*l +: 32] = mem[ra_q*LANES + l];
 endmodule
@@ -0,0 +1,175 @@
+/*
+Per-pixel sprite collision flags.
+
+Watches the drawer's writes into the line buffer. An owner buffer keeps,
+for every pixel of the line, the index of the last sprite that drew an
+opaque pixel there; a write over another sprite's pixel is a sprite-sprite
+hit. A write over a background tile marked as a hazard (tile_hazard, one
+bit per 16-pixel slot of the line) is a sprite-tile hit.
+
+Hits are collected over a frame and copied to the snapshot on frame_tick.
+Reads are answered on rd_clk, the bus clock, from a copy of the snapshot
+taken on the pulse that frame_tick sends across, one word per rd_addr:
+
+0-3   : HIT, sprite n touched another sprite (bit n % 32 of word n / 32)
+4-7   : HAZARD, sprite n touched a hazard tile
+8-39  : PAIR, words 8 + 4r .. 11 + 4r: the sprites that sprite r (0-7)
+        touched, same layout as HIT
+
+The owner buffer is read one clock ahead of its update; a write to the
+group read on the clock before is forwarded.
+*/
+module sprite_collide #(
+    parameter NUM_SPRITE = 128,
+    parameter PAIR_ROWS  = 8
+)(
+    input  logic        clk,
+    input  logic        reset,
+
+    input  logic        line_start,         // a new line's writes follow
+    input  logic        frame_tick,
+
+    // drawer writes
+    input  logic        wren,
+    input  logic [7:0]  pixel_col,          // 4-pixel group
+    input  logic [7:0]  pixel_be,           // 2 bits per pixel
+    input  logic [6:0]  pixel_id,
+    input  logic [40:0] tile_hazard,        // per tile slot of the line
+
+    input  logic        rd_clk,
+    input  logic [5:0]  rd_addr,            // rd_clk
+    output logic [31:0] rd_data,
+    output logic        any_hit             // snapshot has a sprite-sprite hit
+);
+
+    localparam int GROUPS = 164;
+
+    // owner: 4 x {valid, index} per group; grp_valid clears a line at once
+    logic [31:0]       owner [GROUPS];
+    logic [31:0]       owner_q;
+    logic [GROUPS-1:0] grp_valid;
+
+    logic       a_valid;
+    logic [7:0] a_col;
+    logic [3:0] a_opaque;
+    logic [6:0] a_id;
+
+    logic        w_valid;               // last update, for forwarding
+    logic [7:0]  w_col;
+    logic [31:0] w_data;
+
+    logic [NUM_SPRITE-1:0] hit_acc, haz_acc, hit_snap, haz_snap;
+    logic [NUM_SPRITE-1:0] pair_acc  [PAIR_ROWS];
+    logic [NUM_SPRITE-1:0] pair_snap [PAIR_ROWS];
+
+    // Compare the written pixels against their owners
+    logic [31:0] cur, upd;
+    logic [3:0]  clash;
+    logic [6:0]  old_id [4];
+
+    always_comb begin
+        cur = (w_valid && w_col == a_col) ? w_data : owner_q;
+        for (int i = 0; i < 4; i++) begin
+            automatic logic old_valid = grp_valid[a_col] && cur[8*i+7];
+            old_id[i]     = cur[8*i +: 7];
+            clash[i]      = a_valid && a_opaque[i] && old_valid && old_id[i] != a_id;
+            upd[8*i +: 8] = a_opaque[i] ? {1'b1, a_id} : old_valid ? cur[8*i +: 8] : 8'd0;
+        end
+    end
+
+    always_ff @(posedge clk) begin
+        owner_q <= owner[pixel_col];
+        if (a_valid)
+            owner[a_col] <= upd;
+    end
+
+    always_ff @(posedge clk) begin
+        if (reset) begin
+            a_valid   <= 0;
+            w_valid   <= 0;
+            grp_valid <= '0;
+            hit_acc   <= '0;
+            haz_acc   <= '0;
+            hit_snap  <= '0;
+            haz_snap  <= '0;
+            for (int r = 0; r < PAIR_ROWS; r++) begin
+                pair_acc[r]  <= '0;
+                pair_snap[r] <= '0;
+            end
+        end
+        else begin
+            a_valid  <= wren && pixel_col < GROUPS;
+            a_col    <= pixel_col;
+            a_id     <= pixel_id;
+            for (int i = 0; i < 4; i++)
+                a_opaque[i] <= pixel_be[2*i];
+
+            w_valid <= a_valid;
+            w_col   <= a_col;
+            w_data  <= upd;
+
+            if (line_start)
+                grp_valid <= '0;
+            else if (a_valid)
+                grp_valid[a_col] <= 1'b1;
+
+            if (frame_tick) begin
+                hit_snap <= hit_acc;
+                haz_snap <= haz_acc;
+                hit_acc  <= '0;
+                haz_acc  <= '0;
+                for (int r = 0; r < PAIR_ROWS; r++) begin
+                    pair_snap[r] <= pair_acc[r];
+                    pair_acc[r]  <= '0;
+                end
+            end
+            else begin
+                for (int i = 0; i < 4; i++)
+                    if (clash[i]) begin
+                        hit_acc[old_id[i]] <= 1'b1;
+                        hit_acc[a_id]      <= 1'b1;
+                        if (old_id[i] < PAIR_ROWS)
+                            pair_acc[old_id[i]][a_id] <= 1'b1;
+                        if (a_id < PAIR_ROWS)
+                            pair_acc[a_id][old_id[i]] <= 1'b1;
+                    end
+                if (a_valid && a_opaque != 4'd0 && tile_hazard[a_col[7:2]])
+                    haz_acc[a_id] <= 1'b1;
+            end
+        end
+    end
+
+    assign any_hit = hit_snap != '0;
+
+    // The snapshot holds for a frame after the tick that sets it, long
+    // after the pulse has crossed
+    logic                  hold_now;
+    logic [NUM_SPRITE-1:0] hit_hold, haz_hold;
+    logic [NUM_SPRITE-1:0] pair_hold [PAIR_ROWS];
+
+    cdc_pulse u_snap_pulse(
+        .src_clk   (clk),
+        .src_reset (reset),
+        .src_pulse (frame_tick),
+        .dst_clk   (rd_clk),
+        .dst_pulse (hold_now)
+    );
+
+    always_ff @(posedge rd_clk)
+        if (hold_now) begin
+            hit_hold  <= hit_snap;
+            haz_hold  <= haz_snap;
+            pair_hold <= pair_snap;
+        end
+
+    always_comb begin
+        if (rd_addr < 6'd4)
+            rd_data = hit_hold[32*rd_addr[1:0] +: 32];
+        else if (rd_addr < 6'd8)
+            rd_data = haz_hold[32*rd_addr[1:0] +: 32];
+        else if (rd_addr < 6'd8 + 4 * PAIR_ROWS)
+            rd_data = pair_hold[(rd_addr - 6'd8) >> 2][32*rd_addr[1:0] +: 32];
+        else
+            rd_data = 32'd0;
+    end
+endmodule
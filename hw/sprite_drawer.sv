@@ -1,63 +1,183 @@
+/*
+Pipelined sprite drawer, 4 pixels per clock.
+
+fetch  : one 64-bit pattern word (4 pixels) per clock, 4 words per sprite
+         row (8 for a wide sprite, the second 4 from frame + 1), plus one
+         tail clock when col_base is not 4-pixel aligned
+lookup : the word is flipped if needed, and an indexed word's four pixels
+         are sent to the palette, which answers on the next clock
+align  : the word is shifted by col_base[1:0] against the previous word,
+         giving one aligned 4-pixel group of the line
+write  : masked write of the group, one byte-enable pair per opaque pixel
+
+A new sprite is accepted while the last word of the current one is being
+fetched, so back-to-back sprites cost 4 or 5 clocks each (8 or 9 when wide).
+
+pixel_id carries the attribute index of the sprite that owns the write,
+for collision detection.
+
+Both pattern stores are read with the same address. An indexed sprite
+takes its four 4-bit pixels from rom4_q and expands them to RGB555 through
+its palette; index 0 is transparent.
+*/
 module sprite_drawer (
     input  logic        clk,
     input  logic        reset,
 
     input  logic        start,
+    output logic        ready,          // start is taken this clock
     input  logic [9:0]  col_base,
     input  logic        flip,
+    input  logic        wide,
     input  logic [7:0]  frame_id,
     input  logic [3:0]  row_off,
+    input  logic        indexed,        // 4 bpp frame from the indexed store
+    input  logic [3:0]  palette,
+    input  logic [6:0]  id,
+
+    // pattern stores
+    output logic [13:0] rom_addr,
+    input  logic [63:0] rom_q,          // direct colour, frames 0-127
+    input  logic [15:0] rom4_q,         // indexed
 
-    // ROM
-    output logic [15:0] rom_addr,
-    input  logic [15:0] rom_q,
+    // palette lookup for the four pixels, registered: pal_data answers the
+    // pal_addr of the previous clock
+    output logic [31:0] pal_addr,       // {palette, index} per pixel
+    input  logic [59:0] pal_data,       // RGB555 per pixel
 
-    output logic [9:0]  pixel_col,
-    output logic [15:0] pixel_data,
+    output logic [7:0]  pixel_col,      // 4-pixel group
+    output logic [63:0] pixel_data,
+    output logic [7:0]  pixel_be,
+    output logic [6:0]  pixel_id,
     output logic        wren,
     output logic        done
 );
 
-    logic [3:0] idx;          // 0‑15
-    logic [3:0] idx_d;
-    logic       valid_d;
+    localparam logic [15:0] TRANSPARENT = 16'h8000;
+
+    //------------------------------------------------ fetch
+    logic       f_active;
+    logic [3:0] f_k, f_last;
+    logic [7:0] f_frame;
+    logic [3:0] f_row;
+    logic       f_flip, f_wide;
+    logic       f_indexed;
+    logic [3:0] f_pal;
+    logic [6:0] f_id;
+    logic [9:0] f_col;
+    logic [2:0] f_src;          // word within the row, mirrored when flipped
+
+    assign f_src    = f_flip ? (f_wide ? 3'd7 : 3'd3) - f_k[2:0] : f_k[2:0];
+    assign ready    = !f_active || f_k == f_last;
+    assign rom_addr = {f_frame + f_src[2], f_row, f_src[1:0]};
+
+    //------------------------------------------------ lookup (ROM data valid)
+    logic       s1_valid, s1_first, s1_tail, s1_flip;
+    logic       s1_indexed;
+    logic [3:0] s1_pal;
+    logic [6:0] s1_id;
+    logic [3:0] nib [4];
+    logic [1:0] s1_shift;
+    logic [8:0] s1_group;
+
+    always_comb
+        for (int i = 0; i < 4; i++) begin
+            nib[i] = s1_flip ? rom4_q[4*(3-i) +: 4] : rom4_q[4*i +: 4];
+            pal_addr[8*i +: 8] = {s1_pal, nib[i]};
+        end
+
+    //------------------------------------------------ align (palette valid)
+    logic        s2_valid, s2_first, s2_tail;
+    logic        s2_indexed;
+    logic [6:0]  s2_id;
+    logic [1:0]  s2_shift;
+    logic [8:0]  s2_group;
+    logic [15:0] s2_rgb [4];            // direct colour pixels, flipped
+    logic [3:0]  s2_clear;              // indexed pixel is index 0
+
+    logic [15:0] cur  [4];
+    logic [15:0] prev [4];
+    logic [15:0] win  [8];
+    logic [15:0] outp [4];
+
+    always_comb begin
+        for (int i = 0; i < 4; i++) begin
+            cur[i]     = s2_tail ? TRANSPARENT :
+                         s2_indexed ? (s2_clear[i] ? TRANSPARENT : {1'b0, pal_data[15*i +: 15]}) :
+                         s2_rgb[i];
+            win[i]     = s2_first ? TRANSPARENT : prev[i];
+            win[i + 4] = cur[i];
+        end
+        for (int i = 0; i < 4; i++)
+            outp[i] = win[i + 4 - s2_shift];
+    end
+
+    assign done = !f_active && !s1_valid && !s2_valid && !wren;
 
     always_ff @(posedge clk) begin
         if (reset) begin
-            done  <= 1;
-            idx   <= 0;
-            idx_d <= 0;
-            valid_d <= 0;
-            rom_addr <= 0;
+            f_active <= 0;
+            f_k <= 0;
+            f_last <= 0;
+            s1_valid <= 0;
+            s2_valid <= 0;
             wren <= 0;
         end else begin
-            if (start) begin
-                done  <= 0;
-                valid_d <= 0;
-                idx <= 0;
-                idx_d <= 0; // FxxKKK, I forgot to reset it, it let me struggle for a long time.
-                rom_addr <= {frame_id, row_off, 4'b0};
-                wren <= 0;
+            // fetch: advance within the sprite, or take the next one
+            if (f_active && f_k != f_last) begin
+                f_k <= f_k + 1'b1;
+            end else if (start) begin
+                f_active <= 1;
+                f_k      <= 0;
+                f_last   <= (wide ? 4'd7 : 4'd3) + (col_base[1:0] != 2'd0);
+                f_frame  <= frame_id;
+                f_row    <= row_off;
+                f_flip   <= flip;
+                f_wide   <= wide;
+                f_indexed <= indexed;
+                f_pal    <= palette;
+                f_id     <= id;
+                f_col    <= col_base;
+            end else begin
+                f_active <= 0;
+            end
+
+            s1_valid <= f_active;
+            s1_first <= f_k == 0;
+            s1_tail  <= f_k == (f_wide ? 4'd8 : 4'd4);
+            s1_flip  <= f_flip;
+            s1_indexed <= f_indexed;
+            s1_pal   <= f_pal;
+            s1_id    <= f_id;
+            s1_shift <= f_col[1:0];
+            s1_group <= {1'b0, f_col[9:2]} + f_k;
+
+            // lookup -> align
+            s2_valid   <= s1_valid;
+            s2_first   <= s1_first;
+            s2_tail    <= s1_tail;
+            s2_indexed <= s1_indexed;
+            s2_id      <= s1_id;
+            s2_shift   <= s1_shift;
+            s2_group   <= s1_group;
+            for (int i = 0; i < 4; i++) begin
+                s2_rgb[i]   <= s1_flip ? rom_q[16*(3-i) +: 16] : rom_q[16*i +: 16];
+                s2_clear[i] <= nib[i] == 4'd0;
+            end
+
+            // align -> write
+            if (s2_valid)
+                for (int i = 0; i < 4; i++)
+                    prev[i] <= cur[i];
+
+            pixel_col <= s2_group[7:0];
+            pixel_id  <= s2_id;
+            for (int i = 0; i < 4; i++) begin
+                pixel_data[16*i +: 16] <= outp[i];
+                pixel_be[2*i +: 2]     <= {2{!outp[i][15]}};
             end
-            else begin
-                // Output
-                pixel_col  <= flip ? (col_base + (10'd15 - {6'b0, idx_d})) : (col_base + {6'b0, idx_d});
-                pixel_data <= rom_q;
-                wren <= (!done) && (valid_d) && (rom_q[15] == 1'b0) && (pixel_col <= 639);
-                if (!done) begin
-                    idx_d   <= idx;
-                    if (idx < 15) begin
-                        rom_addr <= rom_addr + 16'd1;
-                        idx      <= idx + 1;
-                        valid_d  <= 1;
-                    end
-
-                    if (idx_d == 15) begin
-                        done <= 1'b1;
-                        valid_d <= 1'b0;
-                    end
-                end
-            end 
+            wren <= s2_valid && s2_group < 9'd164 &&
+                    (!outp[0][15] || !outp[1][15] || !outp[2][15] || !outp[3][15]);
         end
     end
 endmodule
@@ -1,7 +1,11 @@
 /* sprite_attr
 [31] : Enable = 1, Disable = 0
 [30] : Flip = 1, otherise = 0
-[29: 27]: Reserved
+[29] : Indexed = 1, 4 bpp frame from sprite_pattern4_ram through the
+       sprite's palette (SPRITE_PALETTE); 0 = RGB555 frame (0-127)
+[28:27]: Size, 00 = 16x16, 01 = 32x16, 10 = 16x32, 11 = 32x32
+         larger sprites use consecutive frames, row-major:
+         32x16 f, f+1 | 16x32 f over f+1 | 32x32 f, f+1 over f+2, f+3
 [26:18] sprite_pos_row (0-479)
 [17:8] : sprite_pos_col (0-639)
 [7:0] : frame_id (0-255)
@@ -10,23 +14,66 @@
 // Test example: 1000 0100 0000 0001 0000 0000 0000 0001
 //               8      4   0   1       0   0   0   1
 module sprite_engine #(
-    parameter NUM_SPRITE = 32,
-    parameter MAX_SLOT   = 8
+    parameter NUM_SPRITE   = 128,
+    parameter LANES        = 4,
+    parameter MAX_PER_LINE = 64,
+    parameter CHANNELS     = 16
 )(
     input  logic        clk,
     input  logic        reset,
 
     input  logic        sprite_start,
+    input  logic        eval_prefetch,      // builds line 0's list before the frame starts
 
     input  logic [9:0]  vcount,
+    input  logic [3:0]  col_offset,         // tile_engine fine_x for the line being drawn
 
     input  logic                            spr_wr_en,
     input  logic [$clog2(NUM_SPRITE)-1:0]   spr_wr_idx,
     input  logic [31:0]                     spr_wr_data,
+    input  logic                            anim_wr_en,     // animation word, same index/data
+    input  logic                            frame_tick,     // start of vblank, steps animations and motion
 
-    output logic [9:0]  sprite_pixel_col,
-    output logic [15:0] sprite_pixel_data,
+    // motion channel registers, {channel, reg}
+    // Motion and collision reads are on rd_clk, the bus clock
+    input  logic                            rd_clk,
+
+    input  logic                            motion_wr_en,
+    input  logic [$clog2(CHANNELS)+2:0]     motion_wr_addr,
+    input  logic [$clog2(CHANNELS)+2:0]     motion_rd_addr,
+    output logic [31:0]                     motion_rd_data,
+
+    // palettes, {palette, index} -> RGB555, and per-sprite palette select
+    input  logic                            pal_wr_en,
+    input  logic [7:0]                      pal_wr_addr,
+    input  logic [14:0]                     pal_wr_data,
+    input  logic                            palsel_wr_en,
+    input  logic [$clog2(NUM_SPRITE)-1:0]   palsel_wr_idx,
+    input  logic [3:0]                      palsel_wr_data,
+
+    // pattern RAMs: direct, one pixel pair per write (frame * 128 + row * 8
+    // + pair); indexed, 8 pixels per write (frame * 32 + row * 2 + half)
+    input  logic                            pat_wr_en,
+    input  logic [13:0]                     pat_wr_addr,
+    input  logic                            pat4_wr_en,
+    input  logic [12:0]                     pat4_wr_addr,
+    input  logic [31:0]                     pat_wr_data,
+
+    output logic [7:0]  sprite_pixel_col,   // 4-pixel group
+    output logic [63:0] sprite_pixel_data,
+    output logic [7:0]  sprite_pixel_be,
     output logic        wren_pixel_draw,
+
+    // collision flags of the last frame (see sprite_collide)
+    input  logic [40:0] tile_hazard,        // hazard tiles of the line being drawn
+    input  logic [5:0]  coll_rd_addr,
+    output logic [31:0] coll_rd_data,
+    output logic        coll_any,
+
+    // per visible line: sprites on it and sprites that did not fit the list
+    output logic        stat_valid,
+    output logic [7:0]  stat_sprites,
+    output logic [7:0]  stat_dropped,
     // debug
     // input logic [4:0] debug_addr,
     // output logic [31:0] debug_data,
@@ -37,8 +84,8 @@ module sprite_engine #(
     assign next_vcount = (vcount < 10'd479) ? vcount + 10'd1 :
                          (vcount == 10'd524) ? 10'd0      : vcount + 1;
 
-    logic [31:0] attr_rd;
-    logic [$clog2(NUM_SPRITE)-1:0] attr_ra;
+    logic [32*LANES-1:0] attr_rd;
+    logic [$clog2(NUM_SPRITE/LANES)-1:0] attr_ra;
 
     sprite_attr_ram u_ram(
         .clock (clk),
@@ -48,53 +95,223 @@ module sprite_engine #(
         .wren (spr_wr_en),
         .q(attr_rd) );
 
+    logic [LANES-1:0]   anim_en, link_en;
+    logic [8*LANES-1:0] anim_base, anim_step;
+    logic [4*LANES-1:0] link_chan;
+
+    sprite_anim #(
+        .NUM_SPRITE (NUM_SPRITE),
+        .LANES      (LANES)
+    ) u_anim (
+        .clk        (clk),
+        .reset      (reset),
+        .wr_en      (anim_wr_en),
+        .wr_idx     (spr_wr_idx),
+        .wr_data    (spr_wr_data),
+        .frame_tick (frame_tick),
+        .busy       (),
+        .ra         (attr_ra),
+        .anim_en    (anim_en),
+        .anim_base  (anim_base),
+        .anim_step  (anim_step),
+        .link_en    (link_en),
+        .link_chan  (link_chan)
+    );
+
+    // Palette select, read beside the attribute words like the anim step
+    logic [3:0]         pal_sel [NUM_SPRITE];
+    logic [4*LANES-1:0] pal_sel_rd;
+
+    always_ff @(posedge clk) begin
+        if (palsel_wr_en)
+            pal_sel[palsel_wr_idx] <= palsel_wr_data;
+        for (int l = 0; l < LANES; l++)
+            pal_sel_rd[4*l +: 4] <= pal_sel[attr_ra*LANES + l];
+    end
+
+    logic [10*CHANNELS-1:0] chan_x;
+    logic [9*CHANNELS-1:0]  chan_y;
+
+    sprite_motion #(
+        .CHANNELS   (CHANNELS)
+    ) u_motion (
+        .clk        (clk),
+        .reset      (reset),
+        .wr_en      (motion_wr_en),
+        .wr_addr    (motion_wr_addr),
+        .wr_data    (spr_wr_data),
+        .rd_clk     (rd_clk),
+        .rd_addr    (motion_rd_addr),
+        .rd_data    (motion_rd_data),
+        .frame_tick (frame_tick),
+        .chan_x     (chan_x),
+        .chan_y     (chan_y)
+    );
+
+    // Evaluation runs one line ahead of drawing
+    logic eval_start;
+    logic [9:0] eval_line;
+    assign eval_start = sprite_start || eval_prefetch;
+    assign eval_line  = eval_prefetch ? 10'd0 : next_vcount + 10'd1;
+
+    logic [$clog2(MAX_PER_LINE)-1:0] list_ra;
+    logic [41:0] list_rd;
+    logic [$clog2(MAX_PER_LINE):0] list_cnt;
+    logic [9:0] list_line;
+    logic eval_overflow, eval_done;
+    logic [$clog2(NUM_SPRITE):0] eval_hits;
+
+    sprite_eval #(
+        .NUM_SPRITE   (NUM_SPRITE),
+        .LANES        (LANES),
+        .MAX_PER_LINE (MAX_PER_LINE),
+        .CHANNELS     (CHANNELS)
+    ) u_eval (
+        .clk        (clk),
+        .reset      (reset),
+        .eval_start (eval_start),
+        .eval_line  (eval_line),
+        .ra         (attr_ra),
+        .rd_data    (attr_rd),
+        .anim_en    (anim_en),
+        .anim_base  (anim_base),
+        .anim_step  (anim_step),
+        .link_en    (link_en),
+        .link_chan  (link_chan),
+        .pal_sel    (pal_sel_rd),
+        .chan_x     (chan_x),
+        .chan_y     (chan_y),
+        .list_ra    (list_ra),
+        .list_rd    (list_rd),
+        .list_cnt   (list_cnt),
+        .list_line  (list_line),
+        .overflow   (eval_overflow),
+        .eval_done  (eval_done),
+        .stat_valid (stat_valid),
+        .stat_hits  (eval_hits)
+    );
+
+    assign stat_sprites = eval_hits;
+    assign stat_dropped = (eval_hits > MAX_PER_LINE) ? eval_hits - MAX_PER_LINE : 8'd0;
+
     // FE
-    logic fe_draw_req, fe_flip, fe_done;
-    logic dw_done;
+    logic fe_draw_req, fe_flip, fe_wide, fe_done;
+    logic dw_ready, dw_done;
     logic [9:0] fe_col;
     logic [7:0] fe_frame;
+    logic       fe_indexed;
+    logic [3:0] fe_pal;
+    logic [6:0] fe_id;
     logic [3:0] fe_rowoff;
 
     sprite_frontend #(
-        .NUM_SPRITE (NUM_SPRITE),
-        .MAX_SLOT   (MAX_SLOT)
+        .MAX_PER_LINE (MAX_PER_LINE)
     ) u_fe (
         .clk        (clk),
         .reset      (reset),
         .start_row  (sprite_start),
         .next_vcount(next_vcount),
-        .ra         (attr_ra),
-        .rd_data    (attr_rd),
-        .draw_done (dw_done),
+        .col_offset (col_offset),
+        .list_ra    (list_ra),
+        .list_rd    (list_rd),
+        .list_cnt   (list_cnt),
+        .list_line  (list_line),
+        .draw_ready (dw_ready),
+        .draw_done  (dw_done),
         .draw_req   (fe_draw_req),
         .col_base   (fe_col),
         .flip       (fe_flip),
+        .wide       (fe_wide),
         .frame_id   (fe_frame),
+        .indexed    (fe_indexed),
+        .palette    (fe_pal),
+        .sprite_id  (fe_id),
         .row_off    (fe_rowoff),
         .fe_done    (fe_done)
     );
 
-    // ------------------- ROM ------------------------------------------
-    logic [15:0] rom_addr, rom_q;
-    sprite_pattern_rom u_rom (.clock(clk), .address(rom_addr), .q(rom_q));
+    // ------------------- Patterns -------------------------------------
+    logic [13:0] rom_addr;
+    logic [63:0] rom_q;
+    logic [15:0] rom4_q;
+    sprite_pattern_ram u_rom (
+        .clock     (clk),
+        .data      (pat_wr_data),
+        .rdaddress (rom_addr[12:0]),
+        .wraddress (pat_wr_addr),
+        .wren      (pat_wr_en),
+        .q         (rom_q)
+    );
+    sprite_pattern4_ram u_rom4 (
+        .clock     (clk),
+        .data      (pat_wr_data),
+        .rdaddress (rom_addr),
+        .wraddress (pat4_wr_addr),
+        .wren      (pat4_wr_en),
+        .q         (rom4_q)
+    );
+
+    // 16 palettes of 16 colours, read for four pixels at once. The read is
+    // registered and the drawer gives it its own stage.
+    logic [14:0] pal [256];
+    logic [31:0] pal_addr;
+    logic [59:0] pal_data;
+
+    always_ff @(posedge clk) begin
+        if (pal_wr_en)
+            pal[pal_wr_addr] <= pal_wr_data;
+        for (int i = 0; i < 4; i++)
+            pal_data[15*i +: 15] <= pal[pal_addr[8*i +: 8]];
+    end
 
     // ------------------- Drawer ---------------------------------------
+    logic [6:0] dw_pixel_id;
+
     sprite_drawer u_dw (
         .clk       (clk),
         .reset     (reset),
         .start     (fe_draw_req),
+        .ready     (dw_ready),
         .col_base  (fe_col),
         .flip      (fe_flip),
+        .wide      (fe_wide),
         .frame_id  (fe_frame),
         .row_off   (fe_rowoff),
+        .indexed   (fe_indexed),
+        .palette   (fe_pal),
+        .id        (fe_id),
         .rom_addr  (rom_addr),
         .rom_q     (rom_q),
+        .rom4_q    (rom4_q),
+        .pal_addr  (pal_addr),
+        .pal_data  (pal_data),
         .pixel_col (sprite_pixel_col),
         .pixel_data(sprite_pixel_data),
+        .pixel_be  (sprite_pixel_be),
+        .pixel_id  (dw_pixel_id),
         .wren      (wren_pixel_draw),
         .done      (dw_done)
     );
 
+    // ------------------- Collisions -----------------------------------
+    sprite_collide #(
+        .NUM_SPRITE (NUM_SPRITE)
+    ) u_collide (
+        .clk         (clk),
+        .reset       (reset),
+        .line_start  (sprite_start),
+        .frame_tick  (frame_tick),
+        .wren        (wren_pixel_draw),
+        .pixel_col   (sprite_pixel_col),
+        .pixel_be    (sprite_pixel_be),
+        .pixel_id    (dw_pixel_id),
+        .tile_hazard (tile_hazard),
+        .rd_clk      (rd_clk),
+        .rd_addr     (coll_rd_addr),
+        .rd_data     (coll_rd_data),
+        .any_hit     (coll_any)
+    );
+
     assign done = (fe_done) || (vcount >= 479 && vcount < 524);
 
 endmodule
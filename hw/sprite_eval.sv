@@ -0,0 +1,167 @@
+/*
+One-line-ahead sprite evaluation.
+
+While line N is being drawn, the attribute table is scanned LANES entries
+per clock and the sprites covering line N+1 are compacted into one bank of
+a double-buffered per-line list. eval_start swaps the banks, so the list
+built during the previous line becomes readable by the frontend while the
+other bank is rebuilt. 128 sprites / 4 lanes = 32 clocks per line.
+
+List entry: [41:35] sprite index, [34:31] palette, [30] indexed,
+            [29:28] size, [27:19] y, [18:9] col, [8] flip, [7:0] frame_id
+Size bit 1 (tall) makes a sprite 32 lines high instead of 16.
+An animated sprite's frame_id is replaced by base + step, the step scaled
+by the 1, 2 or 4 frames a sprite of its size spans. A sprite linked to a
+motion channel has the channel's position added to its x/y.
+*/
+module sprite_eval #(
+    parameter NUM_SPRITE   = 128,
+    parameter LANES        = 4,
+    parameter MAX_PER_LINE = 64,
+    parameter CHANNELS     = 16
+)(
+    input  logic           clk,
+    input  logic           reset,
+
+    input  logic           eval_start,
+    input  logic [9:0]     eval_line,
+
+    // attribute RAM, LANES entries per word
+    output logic [$clog2(NUM_SPRITE/LANES)-1:0] ra,
+    input  logic [32*LANES-1:0]                 rd_data,
+    // sprite_anim, same address and latency as rd_data
+    input  logic [LANES-1:0]                    anim_en,
+    input  logic [8*LANES-1:0]                  anim_base,
+    input  logic [8*LANES-1:0]                  anim_step,
+    input  logic [LANES-1:0]                    link_en,
+    input  logic [4*LANES-1:0]                  link_chan,
+    // palette select per sprite, same address and latency as rd_data
+    input  logic [4*LANES-1:0]                  pal_sel,
+    // sprite_motion channel positions
+    input  logic [10*CHANNELS-1:0]              chan_x,
+    input  logic [9*CHANNELS-1:0]               chan_y,
+
+    // readable bank: the list for the line being drawn
+    input  logic [$clog2(MAX_PER_LINE)-1:0]     list_ra,
+    output logic [41:0]                         list_rd,
+    output logic [$clog2(MAX_PER_LINE):0]       list_cnt,
+    output logic [9:0]                          list_line,
+
+    output logic           overflow,            // more than MAX_PER_LINE sprites hit the line
+    output logic           eval_done,
+
+    // one pulse per evaluated visible line, with every sprite that hit it
+    output logic           stat_valid,
+    output logic [$clog2(NUM_SPRITE):0]         stat_hits
+);
+
+    localparam int WORDS = NUM_SPRITE / LANES;
+    localparam int WW    = $clog2(WORDS);
+    localparam int CW    = $clog2(MAX_PER_LINE);
+
+    logic [41:0]  list [2][MAX_PER_LINE];
+    logic [CW:0]  cnt  [2];
+    logic [9:0]   line [2];
+    logic         wr_bank;
+
+    logic [WW-1:0] word, rd_word;   // rd_word: the word rd_data holds
+    logic          scanning;
+    logic          rd_valid;        // rd_data holds the word addressed last clock
+
+    assign ra        = word;
+    assign list_rd   = list[~wr_bank][list_ra];
+    assign list_cnt  = cnt[~wr_bank];
+    assign list_line = line[~wr_bank];
+
+    // Hit test and list position for each lane of the current word
+    logic [LANES-1:0] hit;
+    logic [CW:0]      pos [LANES+1];
+    logic [$clog2(NUM_SPRITE):0] hits;   // not capped at MAX_PER_LINE
+    logic [7:0]       frame [LANES];
+    logic [9:0]       sx    [LANES];
+    logic [8:0]       sy    [LANES];
+
+    assign stat_hits = hits;
+
+    always_comb begin
+        pos[0] = cnt[wr_bank];
+        for (int l = 0; l < LANES; l++) begin
+            sx[l] = rd_data[32*l+8 +: 10];
+            sy[l] = rd_data[32*l+18 +: 9];
+            if (link_en[l]) begin
+                sx[l] = sx[l] + chan_x[10*link_chan[4*l +: 4] +: 10];
+                sy[l] = sy[l] + chan_y[9*link_chan[4*l +: 4] +: 9];
+            end
+            hit[l] = rd_valid && rd_data[32*l+31] &&
+                     (line[wr_bank] >= {1'b0, sy[l]}) &&
+                     (line[wr_bank] <  sy[l] + (rd_data[32*l+28] ? 10'd32 : 10'd16));
+            pos[l+1] = pos[l] + hit[l];
+            frame[l] = anim_en[l] ? anim_base[8*l +: 8] +
+                                    (anim_step[8*l +: 8] << ({1'b0, rd_data[32*l+27]} + rd_data[32*l+28]))
+                                  : rd_data[32*l +: 8];
+        end
+    end
+
+    always_ff @(posedge clk) begin
+        if (reset) begin
+            wr_bank   <= 0;
+            cnt[0]    <= 0;
+            cnt[1]    <= 0;
+            line[0]   <= 10'h3FF;
+            line[1]   <= 10'h3FF;
+            word      <= 0;
+            scanning  <= 0;
+            rd_valid  <= 0;
+            overflow  <= 0;
+            eval_done <= 1;
+            hits      <= 0;
+            stat_valid <= 0;
+        end
+        else if (eval_start) begin
+            wr_bank        <= ~wr_bank;
+            cnt[~wr_bank]  <= 0;
+            line[~wr_bank] <= eval_line;
+            word      <= 0;
+            scanning  <= 1;
+            rd_valid  <= 0;
+            overflow  <= 0;
+            eval_done <= 0;
+            hits      <= 0;
+            stat_valid <= 0;
+        end
+        else begin
+            rd_valid <= scanning;
+            rd_word  <= word;
+            if (scanning) begin
+                if (word == WORDS - 1)
+                    scanning <= 0;
+                else
+                    word <= word + 1'b1;
+            end
+
+            // Append hits in table order; lower index draws first
+            for (int l = 0; l < LANES; l++) begin
+                if (hit[l]) begin
+                    if (pos[l] < MAX_PER_LINE)
+                        list[wr_bank][pos[l][CW-1:0]] <= {7'(rd_word * LANES + l),
+                                                          pal_sel[4*l +: 4],
+                                                          rd_data[32*l+27 +: 3],
+                                                          sy[l],
+                                                          sx[l],
+                                                          rd_data[32*l+30],
+                                                          frame[l]};
+                    else
+                        overflow <= 1;
+                end
+            end
+            if (rd_valid) begin
+                cnt[wr_bank] <= (pos[LANES] > MAX_PER_LINE) ? (CW+1)'(MAX_PER_LINE) : pos[LANES];
+                hits <= hits + (pos[LANES] - pos[0]);
+            end
+
+            if (rd_valid && !scanning)
+                eval_done <= 1;
+            stat_valid <= rd_valid && !scanning && line[wr_bank] < 10'd480;
+        end
+    end
+endmodule
@@ -1,72 +1,60 @@
+// Walks the per-line list built by sprite_eval during the previous line
+// and hands its sprites to the drawer back to back (valid/ready).
+// The lower half of a tall sprite is drawn from the frame one pattern row
+// further on: frame + 1, or frame + 2 when the sprite is also wide.
+// Columns are moved right by col_offset, the tile line's fine scroll, so
+// sprites stay put on screen while the background scrolls.
 module sprite_frontend #(
-    parameter NUM_SPRITE = 32,
-    parameter MAX_SLOT   = 8
+    parameter MAX_PER_LINE = 64
 )(
     input  logic           clk,
     input  logic           reset,
 
     input  logic           start_row,
     input  logic [9:0]     next_vcount,
+    input  logic [3:0]     col_offset,
 
-    output logic [$clog2(NUM_SPRITE)-1:0] ra,
-    input  logic [31:0]    rd_data,
+    output logic [$clog2(MAX_PER_LINE)-1:0] list_ra,
+    input  logic [41:0]    list_rd,
+    input  logic [$clog2(MAX_PER_LINE):0]   list_cnt,
+    input  logic [9:0]     list_line,
 
+    input  logic           draw_ready,          // drawer takes draw_req this clock
     input  logic           draw_done,           // drawer: 1‑idle 0‑busy
     output logic           draw_req,
     output logic [9:0]     col_base,
     output logic           flip,
+    output logic           wide,                // 32 pixels: frame and frame + 1 side by side
     output logic [7:0]     frame_id,
+    output logic           indexed,
+    output logic [3:0]     palette,
+    output logic [6:0]     sprite_id,           // attribute table index
     output logic [3:0]     row_off,
 
     output logic           fe_done
 );
 
-    localparam int IDXW  = $clog2(NUM_SPRITE);
-    localparam int QPW   = $clog2(MAX_SLOT);
-    localparam int MASK  = MAX_SLOT - 1;
+    localparam int CW = $clog2(MAX_PER_LINE);
 
-    logic [IDXW-1:0] scan_idx;
-    logic [IDXW-1:0] scan_idx_d;
-    logic [IDXW:0] scan_idx_checked; // NUM_SPRITE
-    assign ra = scan_idx;
+    logic [CW:0] idx;
+    logic [4:0]  row;                           // line within the sprite, 0-31
 
-    logic hit;
-    assign hit = rd_data[31] && (next_vcount >= {1'b0,rd_data[26:18]}) && (next_vcount < rd_data[26:18]+16);
-    // FIFO
-    typedef struct packed { logic [9:0] col; logic flip; logic [7:0] frame; logic [3:0] rowoff; } ent_t;
-    ent_t           fifo [MAX_SLOT];
-    logic [QPW-1:0] head, tail;
-    logic [QPW-1:0]   cnt;
+    assign row = next_vcount[4:0] - list_rd[23:19];
 
-    logic drawing;
-    logic enqueue;
-    assign enqueue = hit && cnt < MAX_SLOT - 1 && ({1'b0,scan_idx_d} != scan_idx_checked) && scan_idx > 0;
-    
-    logic dequeue;
-    assign dequeue = !drawing && cnt != 0;
+    assign list_ra = idx[CW-1:0];
 
     always_ff @(posedge clk) begin
         //------------------------------------------------ reset / blank
         if (reset) begin
-            scan_idx <= 0;
-            scan_idx_d <= 0;
-            scan_idx_checked <= NUM_SPRITE;
-            head<=0;
-            tail<=0;
-            cnt <= 0;
-            draw_req<=0;
-            drawing <= 0;
-            fe_done<=1;
+            idx <= 0;
+            draw_req <= 0;
+            fe_done <= 1;
         end
         else if (start_row) begin
-            scan_idx <= 0;
-            scan_idx_d <= 0;
-            scan_idx_checked <= NUM_SPRITE;
-            head<=0;
-            tail<=0;
-            cnt <= 0;
-            draw_req<=0;
-            drawing <= 0;
+            // sprite_eval swaps its banks on this same edge, so the list is
+            // only looked at from the next clock on
+            idx <= 0;
+            draw_req <= 0;
             if (next_vcount < 10'd480) begin
                 fe_done <= 0;      // visible line
             end else begin
@@ -75,60 +63,28 @@ module sprite_frontend #(
         end
         //----------------------------- normal run
         else if (!fe_done) begin
-            draw_req <= 0;
-            cnt <= cnt + enqueue - dequeue;
-            
-            scan_idx_d <= scan_idx;
-            /*
-            Why we need "-2": Important, because if we just -1, scan_idx will become 9 and keep this value, scan_idx_d become 8 for 1 clk,
-            then after 1clk, scan_idx_d become 9, so we lost 8(scan_idx_d)'s value, it becomes 9's value, waiting for enqueue.
-            */
-            if(scan_idx < NUM_SPRITE - 1 && cnt < MAX_SLOT - 2) begin
-                scan_idx <= scan_idx + 1'b1;
+            // Load the next entry once the current request has been taken
+            if (!draw_req || draw_ready) begin
+                // A list built for another line (a start was skipped) is not drawn
+                if (idx < list_cnt && list_line == next_vcount) begin
+                    col_base <= list_rd[18:9] + col_offset;
+                    flip     <= list_rd[8];
+                    wide     <= list_rd[28];
+                    indexed  <= list_rd[30];
+                    palette  <= list_rd[34:31];
+                    sprite_id <= list_rd[41:35];
+                    frame_id <= list_rd[7:0] + (row[4] ? (list_rd[28] ? 8'd2 : 8'd1) : 8'd0);
+                    row_off  <= row[3:0];
+                    draw_req <= 1;
+                    idx <= idx + 1'b1;
+                end
+                else begin
+                    draw_req <= 0;
+                    // This line is done once the drawer has drained.
+                    if (!draw_req && draw_done)
+                        fe_done <= 1;
+                end
             end
-            // Enqueue
-            if (enqueue) begin
-                scan_idx_checked <= {1'b0,scan_idx_d};
-                fifo[tail].col <= rd_data[17:8];
-                fifo[tail].flip <= rd_data[30];
-                fifo[tail].frame <=rd_data[7:0];
-                fifo[tail].rowoff <= (next_vcount-rd_data[26:18]) & 4'hf;
-                tail <= (tail + 1'b1) & MASK;
-            end
-
-            // drawer idle and queue non empty → Dequeue
-            if (dequeue) begin
-                col_base <= fifo[head].col;
-                flip     <= fifo[head].flip;
-                frame_id <= fifo[head].frame;
-                row_off  <= fifo[head].rowoff;
-                // 1 clk pulse
-                draw_req <= 1;
-
-                // drawing state long period
-                drawing <= 1;
-                head <= (head + 1'b1) & MASK;
-            end
-
-            if(drawing) begin
-                // draw_req <= 0;
-                // Warning!!: should be very careful, because "after" draw_req 1 clk pulse, draw_done set to 0. 
-                // So we can not quickly check draw_done, since it is "1" when draw_req = 1
-                // After draw_req drop to 0(lasting 1 clk), draw_done set to 0. Then we can check draw_done to detect "drawing" state.
-                if (draw_done && !draw_req)
-                    drawing <= 0;
-            end
-
-            // This line is done.
-            // Why we need "!drawing" instead of "draw_done", because after the last one send to drawer, 
-            // it will fe_done <=1 next cycle due to draw_done still 1(but it will drop to 0 next cycle)
-
-            // If only one sprite need to send to drawer
-            // And it is scan_idx_d = NUM_SPRITE-1, because drawing need 1 clk to pull up,
-            // So when this sprite enqueue, at the same cycle, cnt is still 0, then it will trigger fe_done <=1
-            // So we will miss this sprite.
-            if (scan_idx_d == NUM_SPRITE-1 && cnt==0 && !drawing && !enqueue)
-                fe_done <= 1;
         end
     end
 endmodule
@@ -0,0 +1,178 @@
+/*
+Autonomous sprite motion channels.
+
+A sprite links to a channel through its animation word ([29] link,
+[28:25] channel); its attribute x/y then become an offset from the
+channel's position, so every piece of a metasprite can share one channel.
+Positions and velocities are fixed point with 6 fraction bits, and each
+enabled channel moves once per frame at the start of vblank, one channel
+per clock.
+
+Registers, 8 words per channel (word = {channel, reg}):
+
+0 CTRL    : [31] Enable, [3:2] y mode, [1:0] x mode
+            mode 00 free, 01 stop at the bounds, 10 bounce off the bounds,
+            11 oscillate about the middle of the bounds
+1 POS     : [31:16] y, [15:0] x, unsigned 10.6, readable back
+2 VEL     : [31:16] dy, [15:0] dx, signed, 1/64 pixel per vblank
+3 BOUND_X : [31:16] max, [15:0] min, 10.6
+4 BOUND_Y : [31:16] max, [15:0] min, 10.6
+5-7       : Reserved
+
+Reads are answered on rd_clk, the bus clock, from a copy of the registers
+taken after each move pass; the copy is carried across with a pulse and
+held until the next one. A read returns the channel as it was after the
+last vblank's move, so a write shows up in reads from the next vblank.
+*/
+module sprite_motion #(
+    parameter CHANNELS = 16
+)(
+    input  logic        clk,
+    input  logic        reset,
+
+    input  logic        wr_en,
+    input  logic [$clog2(CHANNELS)+2:0] wr_addr,
+    input  logic [31:0] wr_data,
+
+    input  logic        rd_clk,
+    input  logic [$clog2(CHANNELS)+2:0] rd_addr,       // rd_clk
+    output logic [31:0] rd_data,
+
+    input  logic        frame_tick,
+
+    // integer positions for sprite_eval
+    output logic [10*CHANNELS-1:0] chan_x,
+    output logic [9*CHANNELS-1:0]  chan_y
+);
+
+    localparam int CHW = $clog2(CHANNELS);
+
+    localparam logic [1:0] FREE = 2'b00, STOP = 2'b01, BOUNCE = 2'b10, OSC = 2'b11;
+
+    logic        en    [CHANNELS];
+    logic [1:0]  mode_x[CHANNELS], mode_y[CHANNELS];
+    logic [15:0] pos_x [CHANNELS], pos_y [CHANNELS];
+    logic [15:0] vel_x [CHANNELS], vel_y [CHANNELS];
+    logic [15:0] min_x [CHANNELS], max_x [CHANNELS];
+    logic [15:0] min_y [CHANNELS], max_y [CHANNELS];
+
+    always_comb
+        for (int c = 0; c < CHANNELS; c++) begin
+            chan_x[10*c +: 10] = pos_x[c][15:6];
+            chan_y[9*c +: 9]   = pos_y[c][14:6];
+        end
+
+    // One axis, one vblank: {position, velocity}
+    function automatic logic [31:0] move(input logic [15:0] p, input logic [15:0] v,
+                                         input logic [15:0] lo, input logic [15:0] hi,
+                                         input logic [1:0] mode);
+        logic signed [17:0] n, nv, mid;
+        nv = {{2{v[15]}}, v};
+        if (mode == OSC) begin
+            // spring toward the middle of the bounds, period about 25 vblanks
+            mid = ({2'b0, lo} + {2'b0, hi}) >>> 1;
+            nv  = nv + ((mid - $signed({2'b0, p})) >>> 4);
+        end
+        n = $signed({2'b0, p}) + nv;
+        if (mode == FREE)
+            return {n[15:0], nv[15:0]};
+        if (n < $signed({2'b0, lo}))
+            return {lo, (mode == BOUNCE) ? 16'(-nv) : (mode == STOP) ? 16'd0 : nv[15:0]};
+        if (n > $signed({2'b0, hi}))
+            return {hi, (mode == BOUNCE) ? 16'(-nv) : (mode == STOP) ? 16'd0 : nv[15:0]};
+        return {n[15:0], nv[15:0]};
+    endfunction
+
+    logic           busy;
+    logic [CHW-1:0] ch, rd_ch, wr_ch;
+    logic [31:0]    mx, my;
+
+    assign rd_ch = rd_addr[CHW+2:3];
+    assign wr_ch = wr_addr[CHW+2:3];
+
+    assign mx = move(pos_x[ch], vel_x[ch], min_x[ch], max_x[ch], mode_x[ch]);
+    assign my = move(pos_y[ch], vel_y[ch], min_y[ch], max_y[ch], mode_y[ch]);
+
+    // Read copy: taken the clock after the pass's last move, then held on
+    // rd_clk from the pulse that follows it
+    logic        copy_now, hold_now;
+    logic [31:0] copy [CHANNELS][5];
+    logic [31:0] hold [CHANNELS][5];
+
+    always_ff @(posedge clk)
+        if (copy_now)
+            for (int c = 0; c < CHANNELS; c++) begin
+                copy[c][0] <= {en[c], 27'd0, mode_y[c], mode_x[c]};
+                copy[c][1] <= {pos_y[c], pos_x[c]};
+                copy[c][2] <= {vel_y[c], vel_x[c]};
+                copy[c][3] <= {max_x[c], min_x[c]};
+                copy[c][4] <= {max_y[c], min_y[c]};
+            end
+
+    cdc_pulse u_copy_pulse(
+        .src_clk   (clk),
+        .src_reset (reset),
+        .src_pulse (copy_now),
+        .dst_clk   (rd_clk),
+        .dst_pulse (hold_now)
+    );
+
+    always_ff @(posedge rd_clk)
+        if (hold_now)
+            hold <= copy;
+
+    assign rd_data = rd_addr[2:0] < 3'd5 ? hold[rd_ch][rd_addr[2:0]] : 32'd0;
+
+    always_ff @(posedge clk) begin
+        if (reset) begin
+            busy <= 0;
+            ch   <= 0;
+            copy_now <= 0;
+            for (int c = 0; c < CHANNELS; c++) begin
+                en[c] <= 0;
+                mode_x[c] <= FREE;
+                mode_y[c] <= FREE;
+                pos_x[c] <= 0;
+                pos_y[c] <= 0;
+                vel_x[c] <= 0;
+                vel_y[c] <= 0;
+                min_x[c] <= 0;
+                max_x[c] <= 16'hFFFF;
+                min_y[c] <= 0;
+                max_y[c] <= 16'hFFFF;
+            end
+        end
+        else begin
+            copy_now <= busy && ch == CHANNELS - 1;
+
+            if (frame_tick) begin
+                busy <= 1;
+                ch   <= 0;
+            end else if (busy) begin
+                if (en[ch]) begin
+                    {pos_x[ch], vel_x[ch]} <= mx;
+                    {pos_y[ch], vel_y[ch]} <= my;
+                end
+                if (ch == CHANNELS - 1)
+                    busy <= 0;
+                else
+                    ch <= ch + 1'b1;
+            end
+
+            // Software writes win over the move of the same clock
+            if (wr_en)
+                case (wr_addr[2:0])
+                    3'd0: begin
+                        en[wr_ch]     <= wr_data[31];
+                        mode_y[wr_ch] <= wr_data[3:2];
+                        mode_x[wr_ch] <= wr_data[1:0];
+                    end
+                    3'd1: {pos_y[wr_ch], pos_x[wr_ch]} <= wr_data;
+                    3'd2: {vel_y[wr_ch], vel_x[wr_ch]} <= wr_data;
+                    3'd3: {max_x[wr_ch], min_x[wr_ch]} <= wr_data;
+                    3'd4: {max_y[wr_ch], min_y[wr_ch]} <= wr_data;
+                    default: ;
+                endcase
+        end
+    end
+endmodule
@@ -0,0 +1,211 @@
+`timescale 1ns/1ps
+
+// Measures how many sprites the engine draws per line and per frame.
+// Runs sprite_engine against the line timing of the render clock, twice
+// the bus clock, and reports drops and missed swaps.
+// Simulate with sprite_attr_ram_test.sv in place of the RAM IP.
+module tb_sprite_capacity;
+
+    parameter NUM_SPRITE   = 128;
+    parameter LANES        = 4;
+    parameter MAX_PER_LINE = 64;
+
+    // Render clocks per line, sprite start after the line begins, and the
+    // last clock the drawing can end to make the swap at bus hcount 1590,
+    // less the line_go and done flag crossings
+    parameter LINE  = 3200;
+    parameter START = 60;
+    parameter SWAP  = 3170;
+
+    logic clk;
+    logic reset;
+    logic [11:0] hcount;
+    logic [9:0]  vcount;
+
+    logic sprite_start, sprite_prefetch;
+    logic spr_wr_en;
+    logic [6:0]  spr_wr_idx;
+    logic [31:0] spr_wr_data;
+
+    logic [7:0]  sprite_pixel_col;
+    logic [63:0] sprite_pixel_data;
+    logic [7:0]  sprite_pixel_be;
+    logic        wren_pixel_draw;
+    logic        done;
+
+    always #5 clk = ~clk;
+
+    sprite_engine #(
+        .NUM_SPRITE   (NUM_SPRITE),
+        .LANES        (LANES),
+        .MAX_PER_LINE (MAX_PER_LINE)
+    ) u_eng (
+        .clk              (clk),
+        .reset            (reset),
+        .sprite_start     (sprite_start),
+        .eval_prefetch    (sprite_prefetch),
+        .vcount           (vcount),
+        .col_offset       (4'd0),
+        .spr_wr_en        (spr_wr_en),
+        .spr_wr_idx       (spr_wr_idx),
+        .spr_wr_data      (spr_wr_data),
+        .anim_wr_en       (1'b0),
+        .frame_tick       (1'b0),
+        .rd_clk           (clk),
+        .motion_wr_en     (1'b0),
+        .motion_wr_addr   (7'd0),
+        .motion_rd_addr   (7'd0),
+        .motion_rd_data   (),
+        .pal_wr_en        (1'b0),
+        .pal_wr_addr      (8'd0),
+        .pal_wr_data      (15'd0),
+        .palsel_wr_en     (1'b0),
+        .palsel_wr_idx    (7'd0),
+        .palsel_wr_data   (4'd0),
+        .pat_wr_en        (1'b0),
+        .pat_wr_addr      (14'd0),
+        .pat4_wr_en       (1'b0),
+        .pat4_wr_addr     (13'd0),
+        .pat_wr_data      (32'd0),
+        .sprite_pixel_col (sprite_pixel_col),
+        .sprite_pixel_data(sprite_pixel_data),
+        .sprite_pixel_be  (sprite_pixel_be),
+        .wren_pixel_draw  (wren_pixel_draw),
+        .tile_hazard      (41'd0),
+        .coll_rd_addr     (6'd0),
+        .coll_rd_data     (),
+        .coll_any         (),
+        .done             (done)
+    );
+
+    // Same start/swap rules as vga_top's render side
+    logic run;
+    always_ff @(posedge clk) begin
+        if (reset || !run) begin
+            hcount <= 0;
+            vcount <= 10'd523;
+            sprite_start <= 0;
+            sprite_prefetch <= 0;
+        end else begin
+            hcount <= (hcount == LINE - 1) ? 12'd0 : hcount + 1'b1;
+            if (hcount == LINE - 1)
+                vcount <= (vcount == 10'd524) ? 10'd0 : vcount + 1'b1;
+            sprite_start <= (vcount < 479 || vcount == 524) && hcount == START && done;
+            sprite_prefetch <= (vcount == 523 && hcount == START);
+        end
+    end
+
+    // Per-line statistics, sampled at the swap point
+    integer line_drawn, line_max, missed_swaps;
+    integer busy, busy_max;             // clocks from sprite_start until the line is drawn
+    logic [NUM_SPRITE-1:0] seen;
+
+    // Plain always: run_frame() also resets these
+    always @(posedge clk) begin
+        if (run && u_eng.fe_draw_req && u_eng.dw_ready) begin
+            line_drawn <= line_drawn + 1;
+            seen[u_eng.fe_frame[6:0]] <= 1'b1;
+        end
+        if (run && hcount == SWAP && (vcount < 479 || vcount == 524)) begin
+            if (line_drawn > line_max)
+                line_max <= line_drawn;
+            if (!done)
+                missed_swaps <= missed_swaps + 1;
+            line_drawn <= 0;
+        end
+        if (run && sprite_start)
+            busy <= 0;
+        else if (run && !done)
+            busy <= busy + 1;
+        else if (run && busy > busy_max)
+            busy_max <= busy;
+    end
+
+    task write_sprite(input [6:0] idx, input [31:0] data);
+        begin
+            @(posedge clk);
+            spr_wr_en   = 1;
+            spr_wr_idx  = idx;
+            spr_wr_data = data;
+            @(posedge clk);
+            spr_wr_en   = 0;
+        end
+    endtask
+
+    // enable | size | y | x | frame, frame doubles as the sprite's id
+    function automatic [31:0] attr(input [8:0] y, input [9:0] x, input [7:0] frame,
+                                   input [1:0] size = 2'b00);
+        attr = {1'b1, 1'b0, 1'b0, size, y, x, frame};
+    endfunction
+
+    task run_frame;
+        begin
+            line_drawn = 0;
+            line_max = 0;
+            missed_swaps = 0;
+            busy = 0;
+            busy_max = 0;
+            seen = '0;
+            run = 1;
+            // prefetch at 523, then lines 524 (draws 0) .. 478 (draws 479)
+            repeat (527 * LINE) @(posedge clk);
+            run = 0;
+            @(posedge clk);
+        end
+    endtask
+
+    function automatic integer popcount(input [NUM_SPRITE-1:0] v);
+        popcount = 0;
+        for (int k = 0; k < NUM_SPRITE; k++)
+            popcount += v[k];
+    endfunction
+
+    initial begin
+        clk = 0;
+        reset = 1;
+        run = 0;
+        spr_wr_en = 0;
+        spr_wr_idx = 0;
+        spr_wr_data = 0;
+
+        #20 reset = 0;
+
+        // Case 1: every sprite on the same 16 lines
+        for (int k = 0; k < NUM_SPRITE; k++)
+            write_sprite(k, attr(9'd100, (k * 5) % 624, k));
+        run_frame();
+        $display("same line : max %0d sprites/line, %0d of %0d sprites shown, %0d missed swaps, busiest line %0d clocks",
+                 line_max, popcount(seen), NUM_SPRITE, missed_swaps, busy_max);
+
+        // Case 2: 8 sprites per row band, spread down the screen
+        for (int k = 0; k < NUM_SPRITE; k++)
+            write_sprite(k, attr((k / 8) * 24, (k % 8) * 80, k));
+        run_frame();
+        $display("spread    : max %0d sprites/line, %0d of %0d sprites shown, %0d missed swaps, busiest line %0d clocks",
+                 line_max, popcount(seen), NUM_SPRITE, missed_swaps, busy_max);
+
+        // Case 3: exactly MAX_PER_LINE on one line, the rest below
+        for (int k = 0; k < NUM_SPRITE; k++)
+            write_sprite(k, attr(k < MAX_PER_LINE ? 9'd200 : 9'd300 + (k / MAX_PER_LINE) * 20,
+                                 (k % MAX_PER_LINE) * 9, k));
+        run_frame();
+        $display("full line : max %0d sprites/line, %0d of %0d sprites shown, %0d missed swaps, busiest line %0d clocks",
+                 line_max, popcount(seen), NUM_SPRITE, missed_swaps, busy_max);
+
+        // The line budget is SWAP - START render clocks, 3110 against 1530
+        // on the bus clock; the drawer needs 4-5 per sprite
+        $display("drawer    : %0d clocks per sprite on the busiest line, %0d sprites fit in a line",
+                 busy_max / line_max, (SWAP - START) * line_max / busy_max);
+        if (missed_swaps != 0)
+            $display("FAIL: drawing overran the line");
+
+        // Case 4: 32x32 sprites, half of them on the same lines
+        for (int k = 0; k < NUM_SPRITE; k++)
+            write_sprite(k, attr(k < NUM_SPRITE / 2 ? 9'd100 : 9'd300, (k % 32) * 19, k, 2'b11));
+        run_frame();
+        $display("32x32     : max %0d sprites/line, %0d of %0d sprites shown, %0d missed swaps, %0d clocks per sprite",
+                 line_max, popcount(seen), NUM_SPRITE, missed_swaps, busy_max / line_max);
+        $stop;
+    end
+
+endmodule
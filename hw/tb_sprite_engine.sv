@@ -2,39 +2,42 @@
 
 module tb_sprite_engine;
 
-    parameter NUM_SPRITE = 32;
-    parameter MAX_SLOT   = 8;
+    parameter NUM_SPRITE   = 128;
+    parameter LANES        = 4;
+    parameter MAX_PER_LINE = 64;
 
     logic clk;
     logic reset;
     logic sprite_start;
+    logic eval_prefetch;
     logic [9:0] vcount;
 
     logic chipselect;
     logic write;
-    logic [5:0] address;
+    logic [8:0] address;
     logic [31:0] writedata;
 
     logic spr_wr_en;
-    logic [4:0] spr_wr_idx;
+    logic [6:0] spr_wr_idx;
     logic [31:0] spr_wr_data;
 
-    logic sprite_write_reg;
-    logic [4:0] sprite_wr_idx;
+    logic sprite_write_reg, anim_write_reg;
+    logic frame_tick;
+    logic [6:0] sprite_wr_idx;
     logic [31:0] sprite_writedata;
 
     always_ff @(posedge clk) begin
         if (reset) begin
             sprite_write_reg <= 0;
+            anim_write_reg   <= 0;
             sprite_wr_idx    <= 0;
             sprite_writedata <= 0;
         end else begin
-            if (chipselect && write && address[5]) begin
-                sprite_write_reg <= 1;
-                sprite_wr_idx    <= address[4:0];
+            sprite_write_reg <= chipselect && write && address[8:7] == 2'b01;
+            anim_write_reg   <= chipselect && write && address[8:7] == 2'b10;
+            if (chipselect && write) begin
+                sprite_wr_idx    <= address[6:0];
                 sprite_writedata <= writedata;
-            end else begin
-                sprite_write_reg <= 0;
             end
         end
     end
@@ -43,8 +46,9 @@ module tb_sprite_engine;
     assign spr_wr_idx  = sprite_wr_idx;
     assign spr_wr_data = sprite_writedata;
 
-    logic [9:0]  sprite_pixel_col;
-    logic [15:0] sprite_pixel_data;
+    logic [7:0]  sprite_pixel_col;
+    logic [63:0] sprite_pixel_data;
+    logic [7:0]  sprite_pixel_be;
     logic        wren_pixel_draw;
     logic        done;
 
@@ -53,27 +57,56 @@ module tb_sprite_engine;
     // DUT
     sprite_engine #(
         .NUM_SPRITE(NUM_SPRITE),
-        .MAX_SLOT(MAX_SLOT)
+        .LANES(LANES),
+        .MAX_PER_LINE(MAX_PER_LINE)
     ) u_eng (
         .clk(clk),
         .reset(reset),
         .sprite_start(sprite_start),
+        .eval_prefetch(eval_prefetch),
         .vcount(vcount),
+        .col_offset(4'd0),
         .spr_wr_en(spr_wr_en),
         .spr_wr_idx(spr_wr_idx),
         .spr_wr_data(spr_wr_data),
+        .anim_wr_en(anim_write_reg),
+        .frame_tick(frame_tick),
+        .rd_clk(clk),
+        .motion_wr_en(1'b0),
+        .motion_wr_addr(7'd0),
+        .motion_rd_addr(7'd0),
+        .motion_rd_data(),
+        .pal_wr_en(1'b0),
+        .pal_wr_addr(8'd0),
+        .pal_wr_data(15'd0),
+        .palsel_wr_en(1'b0),
+        .palsel_wr_idx(7'd0),
+        .palsel_wr_data(4'd0),
+        .pat_wr_en(1'b0),
+        .pat_wr_addr(14'd0),
+        .pat4_wr_en(1'b0),
+        .pat4_wr_addr(13'd0),
+        .pat_wr_data(32'd0),
         .sprite_pixel_col(sprite_pixel_col),
         .sprite_pixel_data(sprite_pixel_data),
+        .sprite_pixel_be(sprite_pixel_be),
         .wren_pixel_draw(wren_pixel_draw),
+        .tile_hazard(41'd0),
+        .coll_rd_addr(6'd0),
+        .coll_rd_data(),
+        .coll_any(),
         .done(done)
     );
 
     initial begin
         integer i;
+        integer t0;
 
         clk = 0;
         reset = 1;
         sprite_start = 0;
+        eval_prefetch = 0;
+        frame_tick = 0;
         vcount = 0;
 
         chipselect = 0;
@@ -116,19 +149,41 @@ module tb_sprite_engine;
         write_sprite(29, 32'h8322441D);
         write_sprite(30, 32'h8322581E);
         write_sprite(31, 32'h83226C1F);
+        // Sprite 0 cycles frames 0x10-0x12, one step per vblank
+        write_anim(0, {1'b1, 1'b0, 6'd0, 8'h10, 8'd3, 8'd0});
         $display("Write complete.");
 
+        repeat (2) begin
+            frame_tick = 1;
+            @(posedge clk);
+            frame_tick = 0;
+            wait(!u_eng.u_anim.busy);
+            @(posedge clk);
+            @(posedge clk);
+        end
+
+        // Line 199 builds the list for 201; line 200 draws it
+        vcount = 199;
+        sprite_start = 1;
+        @(posedge clk);
+        sprite_start = 0;
+        @(posedge clk);
+        wait(u_eng.eval_done);
+
         vcount = 200;
         sprite_start = 1;
         @(posedge clk);
+        t0 = $time;
         sprite_start = 0;
         @(posedge clk);
+        $display("Animated sprite 0 frame after 2 vblanks: %h (expect 12)", u_eng.list_rd[7:0]);
         @(posedge clk);
         @(posedge clk);
         @(posedge clk);
         @(posedge clk);
 
         wait(done);
+        $display("Line 201: %0d sprites drawn in %0d clocks", u_eng.list_cnt, ($time - t0) / 10);
 
         @(posedge clk);
         @(posedge clk);
@@ -140,12 +195,28 @@ module tb_sprite_engine;
         $stop;
     end
 
-    task write_sprite(input [4:0] idx, input [31:0] data);
+    task write_sprite(input [6:0] idx, input [31:0] data);
+        begin
+            @(posedge clk);
+            chipselect = 1;
+            write = 1;
+            address = {2'b01, idx};
+            writedata = data;
+
+            @(posedge clk);
+            chipselect = 0;
+            write = 0;
+            address = 0;
+            writedata = 0;
+        end
+    endtask
+
+    task write_anim(input [6:0] idx, input [31:0] data);
         begin
             @(posedge clk);
             chipselect = 1;
             write = 1;
-            address = {1'b1, idx};
+            address = {2'b10, idx};
             writedata = data;
 
             @(posedge clk);
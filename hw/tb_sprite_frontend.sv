@@ -2,64 +2,110 @@
 
 module tb_sprite_frontend;
 
-    parameter NUM_SPRITE = 32;
-    parameter MAX_SLOT   = 8;
+    parameter NUM_SPRITE   = 128;
+    parameter LANES        = 4;
+    parameter MAX_PER_LINE = 64;
 
     logic clk;
     logic reset;
     logic start_row;
     logic [9:0] next_vcount;
 
-    // frontend <-> RAM
-    logic [$clog2(NUM_SPRITE)-1:0] attr_ra;
-    logic [31:0] attr_rd;
+    // eval <-> RAM
+    logic [$clog2(NUM_SPRITE/LANES)-1:0] attr_ra;
+    logic [32*LANES-1:0] attr_rd;
+
+    // eval <-> frontend
+    logic [$clog2(MAX_PER_LINE)-1:0] list_ra;
+    logic [41:0] list_rd;
+    logic [$clog2(MAX_PER_LINE):0] list_cnt;
+    logic [9:0] list_line;
+    logic eval_overflow, eval_done;
 
     // frontend <-> drawer
     logic draw_req;
+    logic draw_ready;
     logic draw_done;
     logic [9:0] fe_col;
-    logic fe_flip;
+    logic fe_flip, fe_wide;
     logic [7:0] fe_frame;
     logic [3:0] fe_rowoff;
     logic fe_done;
 
     // drawer <-> ROM
-    logic [15:0] rom_addr;
-    logic [15:0] rom_q;
-    logic [9:0]  pixel_col;
-    logic [15:0] pixel_data;
+    logic [13:0] rom_addr;
+    logic [63:0] rom_q;
+    logic [7:0]  pixel_col;
+    logic [63:0] pixel_data;
+    logic [7:0]  pixel_be;
     logic wren;
 
     logic [31:0] sprite_attr_ram [NUM_SPRITE];
 
-    logic [15:0] sprite_rom [0:65535];
+    logic [63:0] sprite_rom [0:16383];
 
     // clock generation
     always #5 clk = ~clk;
 
+    // DUT: evaluation, run for the line after next_vcount
+    sprite_eval #(
+        .NUM_SPRITE(NUM_SPRITE),
+        .LANES(LANES),
+        .MAX_PER_LINE(MAX_PER_LINE)
+    ) u_eval (
+        .clk(clk),
+        .reset(reset),
+        .eval_start(start_row),
+        .eval_line(next_vcount + 10'd1),
+        .ra(attr_ra),
+        .rd_data(attr_rd),
+        .anim_en('0),
+        .anim_base('0),
+        .anim_step('0),
+        .link_en('0),
+        .link_chan('0),
+        .pal_sel('0),
+        .chan_x('0),
+        .chan_y('0),
+        .list_ra(list_ra),
+        .list_rd(list_rd),
+        .list_cnt(list_cnt),
+        .list_line(list_line),
+        .overflow(eval_overflow),
+        .eval_done(eval_done)
+    );
+
     // DUT: frontend
     sprite_frontend #(
-        .NUM_SPRITE(NUM_SPRITE),
-        .MAX_SLOT(MAX_SLOT)
+        .MAX_PER_LINE(MAX_PER_LINE)
     ) u_fe (
         .clk(clk),
         .reset(reset),
         .start_row(start_row),
         .next_vcount(next_vcount),
-        .ra(attr_ra),
-        .rd_data(attr_rd),
+        .col_offset(4'd0),
+        .list_ra(list_ra),
+        .list_rd(list_rd),
+        .list_cnt(list_cnt),
+        .list_line(list_line),
+        .draw_ready(draw_ready),
         .draw_done(draw_done),
         .draw_req(draw_req),
         .col_base(fe_col),
         .flip(fe_flip),
+        .wide(fe_wide),
         .frame_id(fe_frame),
+        .indexed(),
+        .palette(),
+        .sprite_id(),
         .row_off(fe_rowoff),
         .fe_done(fe_done)
     );
 
-    // Read from sprite_attr_ram
+    // Read LANES entries of sprite_attr_ram
     always_ff @(posedge clk) begin
-        attr_rd <= sprite_attr_ram[attr_ra];
+        for (int l = 0; l < LANES; l++)
+            attr_rd[32*l +: 32] <= sprite_attr_ram[attr_ra*LANES + l];
     end
 
     // DUT: drawer
@@ -67,14 +113,24 @@ module tb_sprite_frontend;
         .clk        (clk),
         .reset      (reset),
         .start      (draw_req),
+        .ready      (draw_ready),
         .col_base   (fe_col),
         .flip       (fe_flip),
+        .wide       (fe_wide),
         .frame_id   (fe_frame),
         .row_off    (fe_rowoff),
+        .indexed    (1'b0),
+        .palette    (4'd0),
+        .id         (7'd0),
         .rom_addr   (rom_addr),
         .rom_q      (rom_q),
+        .rom4_q     (16'd0),
+        .pal_addr   (),
+        .pal_data   (60'd0),
         .pixel_col  (pixel_col),
         .pixel_data (pixel_data),
+        .pixel_be   (pixel_be),
+        .pixel_id   (),
         .wren       (wren),
         .done       (draw_done)
     );
@@ -91,7 +147,7 @@ module tb_sprite_frontend;
         next_vcount = 10'd0;
 
         sprite_attr_ram[0]  = 32'h83200000;
-        sprite_attr_ram[1]  = 32'h83201401;
+        sprite_attr_ram[1]  = 32'h9B201401; // 32x32
         sprite_attr_ram[2]  = 32'h83202802;
         sprite_attr_ram[3]  = 32'h83203C03;
         sprite_attr_ram[4]  = 32'h83205004;
@@ -122,15 +178,25 @@ module tb_sprite_frontend;
         sprite_attr_ram[29] = 32'h8322441D;
         sprite_attr_ram[30] = 32'h8322581E;
         sprite_attr_ram[31] = 32'h83226C1F;
+        for (i = 32; i < NUM_SPRITE; i = i + 1)
+            sprite_attr_ram[i] = 32'h0;
 
         #20 reset = 0;
 
+        // Line 199 builds the list for 200, then line 200 is drawn
+        #20;
+        next_vcount = 10'd199;
+        start_row = 1;
+        #10 start_row = 0;
+        wait(eval_done && fe_done);
+
         #20;
         next_vcount = 10'd200;
         start_row = 1;
         #10 start_row = 0;
 
-        wait(fe_done);
+        #10 wait(fe_done);
+        $display("Line 200: %0d sprites listed, overflow=%0d", list_cnt, eval_overflow);
         #20;
 
         $display("Simulation finished.");
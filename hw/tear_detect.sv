@@ -0,0 +1,109 @@
+/*
+Tear detector for sprite attribute writes.
+
+Keeps a copy of every sprite's enable, y and height as written, so each
+new attribute write can be checked against the range the sprite covered
+before it and the range it covers after. A write during active display
+(vcount < 480) is "active"; it is also "unsafe" when the line on screen or
+the line being evaluated for the next one (vcount + 1) falls inside either
+range, as that line may show the sprite half old and half new. Motion
+channel offsets are not included.
+
+Flags and counts are collected over a frame and copied to the readable
+snapshot on frame_tick, one word per rd_addr:
+
+0-3 : UNSAFE, sprite n was written unsafely (bit n % 32 of word n / 32)
+4-7 : ACTIVE, sprite n was written during active display
+8   : [31:16] active writes, [15:0] unsafe writes (saturating)
+*/
+module tear_detect #(
+    parameter NUM_SPRITE = 128
+)(
+    input  logic        clk,
+    input  logic        reset,
+
+    input  logic [9:0]  vcount,
+    input  logic        frame_tick,
+
+    // sprite attribute writes
+    input  logic        wr_en,
+    input  logic [6:0]  wr_idx,
+    input  logic [31:0] wr_data,
+
+    input  logic [3:0]  rd_addr,
+    output logic [31:0] rd_data
+);
+
+    // enable, tall, y per sprite, as last written
+    logic       shadow_en   [NUM_SPRITE];
+    logic       shadow_tall [NUM_SPRITE];
+    logic [8:0] shadow_y    [NUM_SPRITE];
+
+    logic [NUM_SPRITE-1:0] unsafe_acc, active_acc, unsafe_snap, active_snap;
+    logic [15:0] unsafe_cnt, active_cnt, unsafe_cnt_snap, active_cnt_snap;
+
+    function automatic logic covers(input logic en, input logic tall, input logic [8:0] y,
+                                    input logic [9:0] line);
+        covers = en && line + 10'd1 >= {1'b0, y} && line < y + (tall ? 10'd32 : 10'd16);
+    endfunction
+
+    logic active, unsafe;
+    assign active = wr_en && vcount < 10'd480;
+    assign unsafe = active &&
+                    (covers(shadow_en[wr_idx], shadow_tall[wr_idx], shadow_y[wr_idx], vcount) ||
+                     covers(wr_data[31], wr_data[28], wr_data[26:18], vcount));
+
+    always_ff @(posedge clk) begin
+        if (wr_en) begin
+            shadow_en[wr_idx]   <= wr_data[31];
+            shadow_tall[wr_idx] <= wr_data[28];
+            shadow_y[wr_idx]    <= wr_data[26:18];
+        end
+    end
+
+    always_ff @(posedge clk) begin
+        if (reset) begin
+            unsafe_acc      <= '0;
+            active_acc      <= '0;
+            unsafe_snap     <= '0;
+            active_snap     <= '0;
+            unsafe_cnt      <= 0;
+            active_cnt      <= 0;
+            unsafe_cnt_snap <= 0;
+            active_cnt_snap <= 0;
+        end
+        else if (frame_tick) begin
+            unsafe_snap     <= unsafe_acc;
+            active_snap     <= active_acc;
+            unsafe_cnt_snap <= unsafe_cnt;
+            active_cnt_snap <= active_cnt;
+            unsafe_acc      <= '0;
+            active_acc      <= '0;
+            unsafe_cnt      <= 0;
+            active_cnt      <= 0;
+        end
+        else begin
+            if (active) begin
+                active_acc[wr_idx] <= 1'b1;
+                if (active_cnt != 16'hFFFF)
+                    active_cnt <= active_cnt + 1'b1;
+            end
+            if (unsafe) begin
+                unsafe_acc[wr_idx] <= 1'b1;
+                if (unsafe_cnt != 16'hFFFF)
+                    unsafe_cnt <= unsafe_cnt + 1'b1;
+            end
+        end
+    end
+
+    always_comb begin
+        if (rd_addr < 4'd4)
+            rd_data = unsafe_snap[32*rd_addr[1:0] +: 32];
+        else if (rd_addr < 4'd8)
+            rd_data = active_snap[32*rd_addr[1:0] +: 32];
+        else if (rd_addr == 4'd8)
+            rd_data = {active_cnt_snap, unsafe_cnt_snap};
+        else
+            rd_data = 32'd0;
+    end
+endmodule
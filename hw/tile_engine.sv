@@ -1,72 +1,336 @@
+/*
+Tile background and foreground planes with hardware scrolling.
+
+The map is map_w x map_h tiles (at least 30 rows, up to 128 x 64, with
+tilemap_idx * map_w * map_h inside the 8192-entry tilemap) and wraps at
+its edges. For every line, scroll_x/scroll_y give the map pixel
+shown at the top left of the screen; they must be less than the map's
+width and height in pixels.
+
+41 tiles are drawn per line, starting at the tile under scroll_x, so the
+line buffer holds the line shifted right by fine_x = scroll_x[3:0]. The
+display readout and the sprite columns add fine_x back.
+
+The tilemap is a RAM: software rewrites entries through tm_wr_* while the
+engine keeps reading, so a write shows up from the next line that fetches it.
+Each layer keeps the entries of the last map row it drew, so the 15 other
+lines of a tile row (7 in lowres) take them from registers instead of the
+map RAM. A row is fetched again when its start (row, first column, map
+width, mode) differs, and any tilemap write drops both cached rows.
+
+Tilemap entry: [15] priority, [14:10] reserved, [9] vflip,
+               [8] hflip, [7:0] tile id
+A flipped entry reuses the pattern of an unflipped tile: vflip reads the
+tile's rows bottom up and hflip reverses the 16 pixels of the row.
+
+With fg_en set, a second pass draws the foreground plane from its own map
+(fg_map_w x fg_map_h entries at fg_base) and scroll into the foreground
+line buffer (tile_layer = 1), with fg_fine_x as its readout offset. Pixel
+bit 15 carries the entry's priority on the foreground and is 0 on the
+background. bg_done rises after the first pass, as the sprites only need
+the background in place.
+
+Tile animation: 16 table entries, each written as one word
+[31] enable, [23:16] frame count, [15:8] vblanks per step, [7:0] base tile.
+Every fetched entry whose tile id is an enabled entry's base tile is drawn
+as base + step instead, so the animation frames are the tiles following
+the base. Steps advance on frame_tick and wrap after the frame count;
+writing an entry restarts it at step 0.
+
+tile_hazard has one bit per tile slot of the background line last drawn,
+set when the slot's tile id (before animation) is marked in the 256-bit
+hazard mask, written 32 ids per word through haz_wr_*.
+
+With lowres set the tiles are 8 x 8 and vcount counts 240 rows: tile id t
+is quadrant t[1:0] ([0] right half, [1] lower half) of the 16 x 16 pattern
+t / 4, and scroll, map sizes and fine_x count 8-pixel tiles. 42 tiles are
+drawn per line, two to a line buffer word, and a tile_hazard slot covers
+both tiles of its word.
+*/
 module tile_engine(
     input logic clk,
     input logic reset,
     input logic tile_start,
     input logic [1:0] tilemap_idx,
     input logic [9:0] vcount,
+    input logic [7:0] map_w,
+    input logic [7:0] map_h,
+    input logic [10:0] scroll_x,            // sampled on tile_start
+    input logic [9:0] scroll_y,
+    input logic fg_en,
+    input logic [12:0] fg_base,
+    input logic [7:0] fg_map_w,
+    input logic [7:0] fg_map_h,
+    input logic [10:0] fg_scroll_x,         // sampled on tile_start
+    input logic [9:0] fg_scroll_y,
+    input logic lowres,                     // 8 x 8 tiles, sampled on tile_start
+    input logic tm_wr_en,                   // tilemap entry write
+    input logic [12:0] tm_wr_addr,
+    input logic [15:0] tm_wr_data,
+    input logic frame_tick,                 // start of vblank
+    input logic anim_wr_en,                 // tile animation entry write
+    input logic [3:0] anim_wr_idx,
+    input logic [31:0] anim_wr_data,
+    input logic haz_wr_en,                  // hazard mask word write
+    input logic [2:0] haz_wr_idx,
+    input logic [31:0] haz_wr_data,
+    output logic [3:0] fine_x,              // this line's readout offsets
+    output logic [3:0] fg_fine_x,
+    output logic tile_layer,                // 0 background, 1 foreground
     output logic [5:0] tile_col,
     output logic [255:0] tile_data,
+    output logic bg_done,
     output logic tile_done,
+    output logic [40:0] tile_hazard,
     output logic wren_tile_draw
 );
 
 // internal
-logic [11:0] tilemap_addr;
+logic [12:0] tilemap_addr;
 logic [11:0] tile_pattern_addr;
 
 
+logic [15:0] tile_entry;
 logic [7:0] tile_id;
+logic hflip;                                // entry's hflip and priority, lined up with the pattern row
+logic prio;
+logic half;                                 // lowres: right half of the pattern row
+logic hazard, hazard_d;
+logic [255:0] hazard_mask;
+logic [255:0] pattern_row;
+logic [127:0] tile_half, tile_half_d;       // lowres: this tile's 8 pixels and the last tile's
 logic [9:0] next_vcount;
 logic [5:0] col[2:0];
-assign tile_col = col[2];
+logic [5:0] last_col;
+logic lowres_line;
+assign tile_col = lowres_line ? {1'b0, col[2][5:1]} : col[2];
+assign last_col = lowres_line ? 6'd41 : 6'd40;
+
+// Map line for this screen line, wrapped once: scroll_y < map_h * 16 and
+// next_vcount < 480 <= map_h * 16
+logic [9:0] sy, fg_sy;
+logic [10:0] line_y_raw;
+logic [9:0] line_y;
+logic [10:0] sx, fg_sx;
+logic fg_pending;                           // foreground pass follows this one
+logic setup;                                // one clock to work out the row base
+logic [12:0] row_base;
+logic [7:0] layer_w, layer_h;
+logic [11:0] layer_h_px;
+logic [12:0] layer_base;
+logic [7:0] map_col;
+logic [3:0] tile_row;
+logic [10:0] layer_sx;
+
+// In lowres a word is written once both of its tiles are in
+assign wren_tile_draw = (!tile_done) && !setup && (col[0] > 0) && (!lowres_line || col[2][0]);
 
-assign wren_tile_draw = (!tile_done) && (col[0] > 0);
+assign layer_w = tile_layer ? fg_map_w : map_w;
+assign layer_h = tile_layer ? fg_map_h : map_h;
+assign layer_h_px = lowres_line ? {1'b0, layer_h, 3'd0} : {layer_h, 4'd0};
+assign layer_base = tile_layer ? fg_base : tilemap_idx * (map_w * map_h);
+assign layer_sx = tile_layer ? fg_sx : sx;
 
-assign tilemap_addr = tilemap_idx * 1200 +  (next_vcount >> 4) * 40 + col[0];
+assign line_y_raw = (tile_layer ? fg_sy : sy) + next_vcount;
+assign line_y = (line_y_raw >= layer_h_px) ? line_y_raw - layer_h_px : line_y_raw;
+
+assign tilemap_addr = row_base + map_col;
+logic [15:0] tile_entry_ram;
 tilemap u_tilemap(
-    .address 	(tilemap_addr  ),
     .clock   	(clk),
-    .q       	(tile_id)
+    .data    	(tm_wr_data),
+    .rdaddress	(tilemap_addr  ),
+    .wraddress	(tm_wr_addr),
+    .wren    	(tm_wr_en),
+    .q       	(tile_entry_ram)
 );
 
-assign tile_pattern_addr = (tile_id << 4) + next_vcount[3:0];
+// Tile row cache, per layer. row_hit holds for a pass whose row is cached;
+// otherwise the pass fills the cache as the map entries arrive, lined up
+// with col[1] like the RAM output.
+logic [15:0] row_cache [2][42];
+logic [15:0] row_cache_q;
+logic [29:0] row_key [2];                   // {row base, first column, width, lowres}
+logic [1:0]  row_valid;
+logic        row_hit;
+logic [12:0] setup_row_base;
+logic [7:0]  setup_col;
+logic [29:0] setup_key;
+
+assign tile_entry = row_hit ? row_cache_q : tile_entry_ram;
+
+// Tile animation table
+localparam int TILE_ANIMS = 16;
+logic       anim_en    [TILE_ANIMS];
+logic [7:0] anim_base  [TILE_ANIMS];
+logic [7:0] anim_count [TILE_ANIMS];
+logic [7:0] anim_period[TILE_ANIMS];
+logic [7:0] anim_tick  [TILE_ANIMS];
+logic [7:0] anim_step  [TILE_ANIMS];
+
+always_comb begin
+    tile_id = tile_entry[7:0];
+    for (int a = 0; a < TILE_ANIMS; a++)
+        if (anim_en[a] && tile_entry[7:0] == anim_base[a])
+            tile_id = anim_base[a] + anim_step[a];
+end
+
+always_ff @(posedge clk) begin
+    if (reset) begin
+        for (int a = 0; a < TILE_ANIMS; a++) begin
+            anim_en[a]   <= 0;
+            anim_tick[a] <= 0;
+            anim_step[a] <= 0;
+        end
+    end else begin
+        if (frame_tick)
+            for (int a = 0; a < TILE_ANIMS; a++) begin
+                if (anim_tick[a] + 9'd1 < {1'b0, anim_period[a]}) begin
+                    anim_tick[a] <= anim_tick[a] + 1'b1;
+                end else begin
+                    anim_tick[a] <= 0;
+                    anim_step[a] <= (anim_step[a] + 9'd1 >= {1'b0, anim_count[a]}) ? 8'd0 : anim_step[a] + 1'b1;
+                end
+            end
+        // A new entry restarts its animation
+        if (anim_wr_en) begin
+            anim_en[anim_wr_idx]     <= anim_wr_data[31];
+            anim_count[anim_wr_idx]  <= anim_wr_data[23:16];
+            anim_period[anim_wr_idx] <= anim_wr_data[15:8];
+            anim_base[anim_wr_idx]   <= anim_wr_data[7:0];
+            anim_tick[anim_wr_idx]   <= 0;
+            anim_step[anim_wr_idx]   <= 0;
+        end
+    end
+end
+assign tile_pattern_addr = lowres_line ?
+    {tile_id[7:2], tile_id[1], tile_entry[9] ? 3'd7 - tile_row[2:0] : tile_row[2:0]} :
+    (tile_id << 4) + (tile_entry[9] ? 4'd15 - tile_row : tile_row);
 tile_pattern u_tile_pattern(
     .address 	(tile_pattern_addr  ),
     .clock   	(clk),
-    .q       	(tile_data)
+    .q       	(pattern_row)
 );
 
+always_ff @(posedge clk) begin
+    hflip <= tile_entry[8];
+    prio  <= tile_layer && tile_entry[15];
+    half  <= tile_id[0];
+    hazard <= hazard_mask[tile_entry[7:0]];
+    hazard_d <= hazard;
+    tile_half_d <= tile_half;
+    if (haz_wr_en)
+        hazard_mask[32*haz_wr_idx +: 32] <= haz_wr_data;
+    // lowres leaves the upper slots unwritten
+    if (tile_start && lowres)
+        tile_hazard <= '0;
+    else if (wren_tile_draw && !tile_layer)
+        tile_hazard[tile_col] <= lowres_line ? hazard || hazard_d : hazard;
+end
+
+always_comb begin
+    for (int p = 0; p < 8; p++) begin
+        tile_half[16*p +: 16] = hflip ? pattern_row[16*(8*half + 7 - p) +: 16] : pattern_row[16*(8*half + p) +: 16];
+        tile_half[16*p+15]    = prio;
+    end
+    if (lowres_line)
+        tile_data = {tile_half, tile_half_d};
+    else
+        for (int p = 0; p < 16; p++) begin
+            tile_data[16*p +: 16] = hflip ? pattern_row[16*(15-p) +: 16] : pattern_row[16*p +: 16];
+            tile_data[16*p+15]    = prio;
+        end
+end
+
+assign setup_row_base = layer_base + (lowres_line ? line_y[9:3] : line_y[9:4]) * layer_w;
+assign setup_col = lowres_line ? layer_sx[10:3] : layer_sx[10:4];
+assign setup_key = {setup_row_base, setup_col, layer_w, lowres_line};
+
+always_ff @(posedge clk) begin
+    row_cache_q <= row_cache[tile_layer][col[0]];
+    if (!tile_done && !setup && !row_hit)
+        row_cache[tile_layer][col[1]] <= tile_entry_ram;
+end
+
 always_ff @(posedge clk) begin
     if (reset) begin
         col[0] <= 0;
         col[1] <= 0;
         col[2] <= 0;
+        bg_done <= 1;
         tile_done <= 1;
+        setup <= 0;
+        tile_layer <= 0;
+        fg_pending <= 0;
+        fine_x <= 0;
+        fg_fine_x <= 0;
+        lowres_line <= 0;
+        row_valid <= 0;
+        row_hit <= 0;
     end else begin
         if (tile_start) begin
             col[0] <= 0;
             col[1] <= 0;
             col[2] <= 0;
+            sx <= scroll_x;
+            sy <= scroll_y;
+            fg_sx <= fg_scroll_x;
+            fg_sy <= fg_scroll_y;
+            tile_layer <= 0;
+            fg_pending <= fg_en;
+            lowres_line <= lowres;
             if (vcount < 479) begin
                 next_vcount <= vcount + 1;
+                bg_done <= 0;
                 tile_done <= 0;
+                setup <= 1;
             end else if (vcount >= 479 && vcount < 524) begin
+                bg_done <= 1;
                 tile_done <= 1;
             end else if (vcount == 524) begin
                 next_vcount <= 0;
+                bg_done <= 0;
                 tile_done <= 0;
+                setup <= 1;
             end
+        end else if (setup) begin
+            setup <= 0;
+            row_base <= setup_row_base;
+            tile_row <= lowres_line ? {1'b0, line_y[2:0]} : line_y[3:0];
+            map_col <= setup_col;
+            row_hit <= row_valid[tile_layer] && row_key[tile_layer] == setup_key;
+            row_key[tile_layer] <= setup_key;
+            row_valid[tile_layer] <= 1;
+            if (tile_layer)
+                fg_fine_x <= lowres_line ? {1'b0, fg_sx[2:0]} : fg_sx[3:0];
+            else
+                fine_x <= lowres_line ? {1'b0, sx[2:0]} : sx[3:0];
         end else if (!tile_done) begin
             col[1] <= col[0];
             col[2] <= col[1];
-            if (col[0] < 39) begin
+            if (col[0] < last_col) begin
                 col[0] <= col[0] + 1;
+                map_col <= (map_col + 1'b1 == layer_w) ? 8'd0 : map_col + 1'b1;
             end
-            if (col[2] == 39) begin
-                tile_done <= 1;
+            if (col[2] == last_col) begin
+                bg_done <= 1;
+                if (fg_pending) begin
+                    // same line again, foreground map and scroll
+                    fg_pending <= 0;
+                    tile_layer <= 1;
+                    setup <= 1;
+                    col[0] <= 0;
+                    col[1] <= 0;
+                    col[2] <= 0;
+                end else begin
+                    tile_done <= 1;
+                end
             end
         end
+        // after the setup above, so a write during a fill drops it too
+        if (tm_wr_en)
+            row_valid <= 0;
     end
 end
-    
-endmodule
\ No newline at end of file
+
+endmodule
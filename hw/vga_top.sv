@@ -3,7 +3,7 @@ module vga_top(input logic        clk,
                    input logic [31:0]  writedata,
                    input logic 	   write,
                    input 		   chipselect,
-                   input logic [5:0]  address, // 64
+                   input logic [8:0]  address, // words: registers 0x00-0x7F (tile animation 0x20-0x2F, collisions 0x40-0x67), sprites 0x80-0xFF, animation 0x100-0x17F, motion 0x180-0x1FF
 
                    output logic [31:0] readdata,
                    output logic [7:0] VGA_R, VGA_G, VGA_B,
@@ -11,7 +11,8 @@ module vga_top(input logic        clk,
                    VGA_BLANK_n,
                    output logic 	   VGA_SYNC_n,
                    
-                   output logic [2:0] audio_ctrl);
+                   output logic [2:0] audio_ctrl,
+                   output logic       irq);
 
     // current VGA pixel coord
     logic [10:0]	   hcount;
@@ -19,69 +20,407 @@ module vga_top(input logic        clk,
 
     logic [31:0] status_reg;
     logic [31:0] ctrl_reg;
+    logic        coll_any, coll_any_s;
+
+    // ------------------- Render clock -------------------
+    // The tile engine, the sprite engine and the draw side of the line
+    // buffers run on clk_render, twice the bus clock. VGA timing, the
+    // registers and the display stay on clk. Signals that cross carry an
+    // _r (render side) or _s (synchronized back) suffix.
+    logic clk_render, render_locked, render_reset;
+
+    render_pll u_render_pll(
+        .refclk   (clk),
+        .rst      (reset),
+        .outclk_0 (clk_render),
+        .locked   (render_locked)
+    );
+
+    cdc_sync u_render_reset(.clk(clk_render), .d(reset || !render_locked), .q(render_reset));
+
+    // Raster interrupts: LINE_IRQ [31] line enable, [30] vblank enable,
+    // [9:0] compare line. IRQ_PENDING [1] vblank, [0] line are set when
+    // vblank starts and when vcount reaches the compare line, and cleared
+    // by writing 1s; irq is high while an enabled one is set.
+    logic [31:0] line_irq_reg;
+    logic [1:0]  irq_pending;
+    logic        line_hit;
+
+    assign line_hit = vcount == line_irq_reg[9:0] && hcount == 0;
+    assign irq = (irq_pending[0] && line_irq_reg[31]) || (irq_pending[1] && line_irq_reg[30]);
 
     assign status_reg[19:0] = {hcount[10:1], vcount};
+    assign status_reg[20] = coll_any_s;     // a sprite-sprite hit last frame
+    assign status_reg[21] = vcount >= 10'd480;
+    assign status_reg[23:22] = irq_pending;
+    assign status_reg[31:24] = 0;
     // linebuffer
     // addr
-    logic [5:0] addr_tile_disp;
     logic [9:0] addr_pixel_disp;
     logic [5:0] addr_tile_draw;
-    logic [9:0] addr_pixel_draw;
+    logic [7:0] addr_pixel_draw;
 
     // indata
-    logic [255:0] data_tile_disp;
-    logic [15:0]  data_pixel_disp;
     logic [255:0] data_tile_draw;
-    logic [15:0]  data_pixel_draw;
+    logic [63:0]  data_pixel_draw;
+    logic [7:0]   byteena_pixel_draw;
 
     // wren
-    logic wren_tile_disp;
-    logic wren_pixel_disp;
     logic wren_tile_draw;
     logic wren_pixel_draw;
 
     // outdata
-    logic [255:0] q_tile_disp;
     logic [15:0]  q_pixel_disp;
-    logic [255:0] q_tile_draw;
-    logic [15:0]  q_pixel_draw;
 
     logic switch;
 
-    linebuffer u_linebuffer (.*);
+    logic [63:0]  sprite_pixel_data;
+    logic         wren_tile_layer;
+
+    linebuffer u_linebuffer (
+        .clk_draw           (clk_render),
+        .clk_disp           (clk),
+        .reset              (reset),
+        .switch             (switch),
+        .addr_pixel_disp    (addr_pixel_disp),
+        .addr_tile_draw     (addr_tile_draw),
+        .addr_pixel_draw    (addr_pixel_draw),
+        .data_tile_draw     (data_tile_draw),
+        .data_pixel_draw    (data_pixel_draw),
+        .byteena_pixel_draw (byteena_pixel_draw),
+        .wren_tile_draw     (wren_tile_draw),
+        .wren_pixel_draw    (wren_pixel_draw),
+        .q_pixel_disp       (q_pixel_disp)
+    );
 
     // connection between tile_engine and linebuffer
     assign addr_tile_draw = tile_col;
     assign data_tile_draw = tile_data;
 
+    logic frame_tick, frame_tick_r;
+
+    assign frame_tick = (vcount == 10'd480 && hcount == 0);
+
 	// tile engine
-	logic tile_start;
+	logic tile_start;                           // clk_render
 	// output declaration of module tile_engine
 	logic[5:0] tile_col;
 	logic [255:0] tile_data;
 	logic tile_done;
-	
+	logic bg_done;
+	logic tile_layer;
+	logic [3:0] fine_x, fg_fine_x;              // line being drawn
+	logic [3:0] fine_x_disp, fg_fine_x_disp;    // line being displayed
+	logic fg_en_disp;
+
+    // Low resolution, CTRL[2], taken at vblank: 320 x 240 with 8 x 8
+    // tiles. Row k is drawn during lines 2k - 2 and 2k - 1 (row 0 during
+    // 523 and 524), shown on lines 2k and 2k + 1, and every pixel of it
+    // is shown twice across.
+    logic lowres, lowres_disp;
+    logic draw_start;                           // a line is drawn from this one
+    logic swap_line;                            // the buffers swap at its end
+
+    assign draw_start = lowres ? (vcount < 478 && !vcount[0]) || vcount == 523 :
+                                 vcount < 479 || vcount == 524;
+    assign swap_line  = lowres ? (vcount < 478 && vcount[0]) || vcount == 524 :
+                                 vcount < 479 || vcount == 524;
+
+    assign wren_tile_draw = wren_tile_layer && !tile_layer;
+    // Sprite pixels are written with bit 15 set, so the display can tell
+    // them from the background under a low-priority foreground tile
+    assign data_pixel_draw = sprite_pixel_data | {4{16'h8000}};
+
+    // Foreground plane: its own line buffer pair, filled by the tile
+    // engine's second pass and only read by the display
+    logic [9:0]  fg_addr_pixel_disp;
+    logic [15:0] fg_q_pixel_disp;
+
+    linebuffer u_fg_linebuffer (
+        .clk_draw           (clk_render),
+        .clk_disp           (clk),
+        .reset              (reset),
+        .switch             (switch),
+        .addr_pixel_disp    (fg_addr_pixel_disp),
+        .addr_tile_draw     (tile_col),
+        .addr_pixel_draw    (8'd0),
+        .data_tile_draw     (tile_data),
+        .data_pixel_draw    (64'd0),
+        .byteena_pixel_draw (8'd0),
+        .wren_tile_draw     (wren_tile_layer && tile_layer),
+        .wren_pixel_draw    (1'b0),
+        .q_pixel_disp       (fg_q_pixel_disp)
+    );
+
+    // ------------------- Scrolling -------------------
+    // SCROLL and MAP are written any time and take effect at the next
+    // vblank. With MAP[31] set, each line's scroll comes from the line
+    // scroll table instead of SCROLL; software loads the table in vblank.
+    logic [31:0] scroll_reg, scroll_pending;     // [25:16] y, [10:0] x
+    logic [31:0] map_reg, map_pending;           // [31] line table, [15:8] height, [7:0] width
+    logic [31:0] line_scroll [512];
+    logic [31:0] line_scroll_q;
+    logic [8:0]  line_scroll_idx;
+    logic        line_scroll_we;
+    logic [10:0] tile_scroll_x;
+    logic [9:0]  tile_scroll_y;
+
+    // Foreground plane: FG_SCROLL as SCROLL, FG_MAP [31] enable,
+    // [28:16] first tilemap entry, [15:8] height, [7:0] width; both take
+    // effect at the next vblank. Foreground pixels equal to FG_KEY are
+    // transparent.
+    logic [31:0] fg_scroll_reg, fg_scroll_pending;
+    logic [31:0] fg_map_reg, fg_map_pending;
+    logic [14:0] fg_key;
+
+    assign line_scroll_we = chipselect && write && address == 9'hB;
+
+    always_ff @(posedge clk) begin
+        if (line_scroll_we)
+            line_scroll[line_scroll_idx] <= writedata;
+        // entry for the line tile_engine starts next; in lowres, entry n
+        // is row n
+        if (lowres)
+            line_scroll_q <= line_scroll[(vcount >= 10'd523) ? 9'd0 : vcount[9:1] + 9'd1];
+        else
+            line_scroll_q <= line_scroll[(vcount == 10'd524) ? 9'd0 : vcount[8:0] + 9'd1];
+    end
+
+    // Tilemap upload: TILEMAP_IDX selects the entry, each TILEMAP_DATA write
+    // stores one and moves to the next
+    logic [12:0] tilemap_wr_idx;
+    logic        tilemap_we;
+
+    // Tile animation table, words 0x20-0x2F; hazard tile mask, 0x30-0x37
+    logic tile_anim_we, hazard_we;
+    logic [40:0] tile_hazard;
+
+    assign tile_scroll_x = map_reg[31] ? line_scroll_q[10:0]  : scroll_reg[10:0];
+    assign tile_scroll_y = map_reg[31] ? line_scroll_q[25:16] : scroll_reg[25:16];
+
+    // ------------------- Render-side writes -------------------
+    // Writes to tile and sprite engine state cross in order through a FIFO
+    // as {address, index, data}, where index is the auto-increment index
+    // of the data registers that have one. The render side takes an entry
+    // every clock, so the bus cannot fill it.
+    logic [13:0] pattern_wr_idx;
+    logic [12:0] pattern4_wr_idx;
+    logic [7:0]  palette_wr_idx;
+    logic        wq_push, wq_empty;
+    logic [13:0] wq_idx;
+    logic [54:0] wq_out;
+    logic        wr_r;                          // an entry reaches the render side
+    logic [8:0]  wr_addr_r;
+    logic [13:0] wr_idx_r;
+    logic [31:0] wr_data_r;
+
+    assign wq_push = chipselect && write &&
+                     (address[8:7] != 2'b00 || address[8:4] == 5'h02 || address[8:3] == 6'h06 ||
+                      address == 9'hD || address == 9'hF || address == 9'h11 ||
+                      address == 9'h13 || address == 9'h14);
+
+    always_comb
+        case (address)
+            9'hD:    wq_idx = {1'b0, tilemap_wr_idx};
+            9'hF:    wq_idx = pattern_wr_idx;
+            9'h11:   wq_idx = {6'd0, palette_wr_idx};
+            9'h13:   wq_idx = {1'b0, pattern4_wr_idx};
+            default: wq_idx = 0;
+        endcase
+
+    cdc_fifo #(
+        .W     (55),
+        .DEPTH (16)
+    ) u_write_fifo (
+        .wr_clk   (clk),
+        .wr_reset (reset),
+        .wr_en    (wq_push),
+        .wr_data  ({address, wq_idx, writedata}),
+        .wr_full  (),
+        .rd_clk   (clk_render),
+        .rd_reset (render_reset),
+        .rd_en    (1'b1),
+        .rd_data  (wq_out),
+        .rd_empty (wq_empty)
+    );
+
+    assign wr_r = !wq_empty;
+    assign {wr_addr_r, wr_idx_r, wr_data_r} = wq_out;
+
+    assign tilemap_we   = wr_r && wr_addr_r == 9'hD;
+    assign tile_anim_we = wr_r && wr_addr_r[8:4] == 5'h02;
+    assign hazard_we    = wr_r && wr_addr_r[8:3] == 6'h06;
+
+    // ------------------- Line handoff -------------------
+    // At hcount 1 of every line the bus side latches what the render side
+    // needs for the line and sends line_go across; the latch holds still
+    // until the next line, long after the render side has copied it. The
+    // render side then times the line in its own clocks: the tile engine
+    // starts at once and the sprites SPRITE_START clocks later. In lowres
+    // the engines count rows: line 2k - 2 and 2k - 1 pass k - 1, and
+    // lines 523 and 524 pass 524.
+    localparam int SPRITE_START = 60;
+
+    logic        line_go, line_go_r;
+    logic        line_draw, line_frame, line_prefetch, line_lowres;
+    logic [9:0]  line_vcount;
+    logic [1:0]  line_tilemap_idx;
+    logic [15:0] line_map;                          // {height, width}
+    logic [20:0] line_scroll, line_fg_scroll;       // {y, x}
+    logic [29:0] line_fg_map;                       // {enable, base, height, width}
+
+    logic [9:0]  vcount_r;
+    logic [1:0]  tilemap_idx_r;
+    logic [15:0] map_r;
+    logic [20:0] scroll_r, fg_scroll_r;
+    logic [29:0] fg_map_r;
+    logic [6:0]  line_clk_r;                        // clocks since line_go_r, stops at 127
+    logic        draw_r, frame_r, prefetch_r, lowres_r;
+
+    logic sprite_start;
+    logic sprite_prefetch;
+    logic sprite_done, sprite_done_s;
+    logic tile_done_s;
+
+    assign line_go = hcount == 1;
+
+    always_ff @(posedge clk)
+        if (line_go) begin
+            line_draw        <= draw_start;
+            line_frame       <= vcount == 10'd480;
+            line_prefetch    <= vcount == (lowres ? 10'd522 : 10'd523);
+            line_lowres      <= lowres;
+            line_vcount      <= !lowres          ? vcount :
+                                vcount >= 10'd523 ? 10'd524 :
+                                vcount <  10'd478 ? {1'b0, vcount[9:1]} : vcount;
+            line_tilemap_idx <= ctrl_reg[1:0];
+            line_map         <= map_reg[15:0];
+            line_scroll      <= {tile_scroll_y, tile_scroll_x};
+            line_fg_map      <= {fg_map_reg[31], fg_map_reg[28:0]};
+            line_fg_scroll   <= {fg_scroll_reg[25:16], fg_scroll_reg[10:0]};
+        end
+
+    cdc_pulse u_line_go(
+        .src_clk   (clk),
+        .src_reset (reset),
+        .src_pulse (line_go),
+        .dst_clk   (clk_render),
+        .dst_pulse (line_go_r)
+    );
+
+    always_ff @(posedge clk_render) begin
+        if (render_reset) begin
+            vcount_r <= 0;
+            draw_r <= 0;
+            frame_r <= 0;
+            prefetch_r <= 0;
+            lowres_r <= 0;
+            line_clk_r <= 7'h7F;
+            tile_start <= 0;
+            sprite_start <= 0;
+            sprite_prefetch <= 0;
+            frame_tick_r <= 0;
+        end else begin
+            if (line_go_r) begin
+                draw_r        <= line_draw;
+                frame_r       <= line_frame;
+                prefetch_r    <= line_prefetch;
+                lowres_r      <= line_lowres;
+                vcount_r      <= line_vcount;
+                tilemap_idx_r <= line_tilemap_idx;
+                map_r         <= line_map;
+                scroll_r      <= line_scroll;
+                fg_map_r      <= line_fg_map;
+                fg_scroll_r   <= line_fg_scroll;
+                line_clk_r    <= 0;
+            end else if (line_clk_r != 7'h7F) begin
+                line_clk_r <= line_clk_r + 1'b1;
+            end
+
+            tile_start   <= line_clk_r == 0 && draw_r;
+            frame_tick_r <= line_clk_r == 0 && frame_r;
+            // The background takes about 45 clocks; the foreground pass
+            // goes to its own buffer and overlaps the sprites
+            sprite_start <= line_clk_r == SPRITE_START && draw_r && bg_done && sprite_done;
+            // Line 0's sprite list is built during the last blank line before
+            // it is drawn, after software has finished its vblank attribute
+            // writes
+            sprite_prefetch <= line_clk_r == SPRITE_START && prefetch_r;
+        end
+    end
+
+    // Level flags back to the bus side. fine_x and fg_fine_x are set early
+    // in the line and read at the swap, so they are steady when they cross.
+    cdc_sync #(.W(3)) u_done_sync(
+        .clk (clk),
+        .d   ({tile_done, sprite_done, coll_any}),
+        .q   ({tile_done_s, sprite_done_s, coll_any_s})
+    );
+
 	tile_engine u_tile_engine(
-		.clk         	(clk          ),
-		.reset       	(reset        ),
+		.clk         	(clk_render   ),
+		.reset       	(render_reset ),
 		.tile_start  	(tile_start   ),
-		.tilemap_idx 	(ctrl_reg[1:0]  ),
-		.vcount      	(vcount       ),
+		.tilemap_idx 	(tilemap_idx_r),
+		.vcount      	(vcount_r     ),
+		.map_w       	(map_r[7:0]   ),
+		.map_h       	(map_r[15:8]  ),
+		.scroll_x    	(scroll_r[10:0]),
+		.scroll_y    	(scroll_r[20:11]),
+		.fg_en       	(fg_map_r[29] ),
+		.fg_base     	(fg_map_r[28:16]),
+		.fg_map_w    	(fg_map_r[7:0]),
+		.fg_map_h    	(fg_map_r[15:8]),
+		.fg_scroll_x 	(fg_scroll_r[10:0]),
+		.fg_scroll_y 	(fg_scroll_r[20:11]),
+		.lowres      	(lowres_r     ),
+		.fine_x      	(fine_x       ),
+		.fg_fine_x   	(fg_fine_x    ),
+		.tile_layer  	(tile_layer   ),
+		.tm_wr_en    	(tilemap_we   ),
+		.tm_wr_addr  	(wr_idx_r[12:0]),
+		.tm_wr_data  	(wr_data_r[15:0]),
+		.frame_tick  	(frame_tick_r ),
+		.anim_wr_en  	(tile_anim_we ),
+		.anim_wr_idx 	(wr_addr_r[3:0]),
+		.anim_wr_data	(wr_data_r    ),
+		.haz_wr_en   	(hazard_we    ),
+		.haz_wr_idx  	(wr_addr_r[2:0]),
+		.haz_wr_data 	(wr_data_r    ),
 		.tile_col    	(tile_col     ),
 		.tile_data   	(tile_data    ),
+		.bg_done     	(bg_done      ),
 		.tile_done   	(tile_done    ),
-        .wren_tile_draw (wren_tile_draw)
+		.tile_hazard 	(tile_hazard  ),
+        .wren_tile_draw (wren_tile_layer)
 	);
 	
 
 	// sprite engine
-    logic sprite_start;
-    logic sprite_done;
-
-    logic sprite_write_reg;
-    logic [4:0] sprite_wr_idx;
+    logic sprite_stat_valid, stat_valid_r;
+    logic [7:0] sprite_stat_sprites, stat_sprites_r;
+    logic [7:0] sprite_stat_dropped, stat_dropped_r;
+
+    logic sprite_write_reg;                     // bus side, for the tear detector
+    logic sprite_write_r, anim_write_r, motion_write_r;
+    logic [31:0] motion_readdata;
+    logic [31:0] coll_readdata;
+    logic [6:0] sprite_wr_idx;
     logic [31:0] sprite_writedata;
 
+    // Sprite pattern upload: SPRITE_PAT_IDX selects the pixel pair, each
+    // SPRITE_PAT_DATA write stores one and moves to the next. The indexed
+    // store and the palettes are loaded the same way.
+    logic        pattern_we, pattern4_we, palette_we, palsel_we;
+
+    assign pattern_we     = wr_r && wr_addr_r == 9'hF;
+    assign palette_we     = wr_r && wr_addr_r == 9'h11;
+    assign pattern4_we    = wr_r && wr_addr_r == 9'h13;
+    assign palsel_we      = wr_r && wr_addr_r == 9'h14;
+    assign sprite_write_r = wr_r && wr_addr_r[8:7] == 2'b01;
+    assign anim_write_r   = wr_r && wr_addr_r[8:7] == 2'b10;
+    assign motion_write_r = wr_r && wr_addr_r[8:7] == 2'b11;
+
     always_ff @(posedge clk) begin
         if (reset) begin
             sprite_write_reg <= 0;
@@ -89,29 +428,221 @@ module vga_top(input logic        clk,
             sprite_writedata <= 0;
         end else begin
         // latch data to keep stable
-        if (chipselect && write && address[5]) begin
-            sprite_write_reg <= 1;
-            sprite_wr_idx    <= address[4:0];
+        sprite_write_reg <= chipselect && write && address[8:7] == 2'b01;
+        if (chipselect && write) begin
+            sprite_wr_idx    <= address[6:0];
             sprite_writedata <= writedata;
-        end else begin
-                sprite_write_reg <= 0;
-            end
+        end
         end
     end
+
+    // Motion and collision reads are answered on the bus clock from copies
+    // the engine hands across once a frame
     sprite_engine u_sprite_engine(
-        .clk         	(clk          ),
-        .reset       	(reset        ),
+        .clk         	(clk_render   ),
+        .reset       	(render_reset ),
+        .rd_clk         (clk),
         .sprite_start  	(sprite_start   ),
-        .vcount      	(vcount       ),
-        .spr_wr_en    	(sprite_write_reg     ),
-        .spr_wr_idx   	(sprite_wr_idx    ),
-        .spr_wr_data   	(sprite_writedata    ),
+        .eval_prefetch  (sprite_prefetch),
+        .vcount      	(vcount_r     ),
+        .col_offset     (fine_x),
+        .spr_wr_en    	(sprite_write_r ),
+        .spr_wr_idx   	(wr_addr_r[6:0] ),
+        .spr_wr_data   	(wr_data_r      ),
+        .anim_wr_en     (anim_write_r),
+        .frame_tick     (frame_tick_r),
+        .motion_wr_en   (motion_write_r),
+        .motion_wr_addr (wr_addr_r[6:0]),
+        .motion_rd_addr (address[6:0]),
+        .motion_rd_data (motion_readdata),
+        .pal_wr_en      (palette_we),
+        .pal_wr_addr    (wr_idx_r[7:0]),
+        .pal_wr_data    (wr_data_r[14:0]),
+        .palsel_wr_en   (palsel_we),
+        .palsel_wr_idx  (wr_data_r[14:8]),
+        .palsel_wr_data (wr_data_r[3:0]),
+        .pat_wr_en      (pattern_we),
+        .pat_wr_addr    (wr_idx_r[13:0]),
+        .pat4_wr_en     (pattern4_we),
+        .pat4_wr_addr   (wr_idx_r[12:0]),
+        .pat_wr_data    (wr_data_r),
         .sprite_pixel_col (addr_pixel_draw),
-        .sprite_pixel_data (data_pixel_draw),
+        .sprite_pixel_data (sprite_pixel_data),
+        .sprite_pixel_be (byteena_pixel_draw),
         .wren_pixel_draw (wren_pixel_draw),
+        .tile_hazard (tile_hazard),
+        .coll_rd_addr (address[5:0]),
+        .coll_rd_data (coll_readdata),
+        .coll_any (coll_any),
+        .stat_valid (stat_valid_r),
+        .stat_sprites (stat_sprites_r),
+        .stat_dropped (stat_dropped_r),
         .done (sprite_done)
     );
 
+    // Line statistics: held on the render side until the next line's
+    // arrive, with the valid pulse sent across
+    always_ff @(posedge clk_render)
+        if (stat_valid_r) begin
+            sprite_stat_sprites <= stat_sprites_r;
+            sprite_stat_dropped <= stat_dropped_r;
+        end
+
+    cdc_pulse u_stat_valid(
+        .src_clk   (clk_render),
+        .src_reset (render_reset),
+        .src_pulse (stat_valid_r),
+        .dst_clk   (clk),
+        .dst_pulse (sprite_stat_valid)
+    );
+
+    // ------------------- Tear detector -------------------
+    // Flags sprite attribute writes that land while the sprite is on the
+    // lines being drawn; TEAR_LOG, words 0x74-0x7C, holds the last frame's
+    logic [31:0] tear_readdata;
+
+    tear_detect u_tear_detect(
+        .clk        (clk),
+        .reset      (reset),
+        .vcount     (vcount),
+        .frame_tick (frame_tick),
+        .wr_en      (sprite_write_reg),
+        .wr_idx     (sprite_wr_idx),
+        .wr_data    (sprite_writedata),
+        .rd_addr    (address[3:0] - 4'd4),
+        .rd_data    (tear_readdata)
+    );
+
+    // ------------------- Performance counters -------------------
+    // Accumulated over the lines of a frame and copied to the readable
+    // snapshot at the start of vblank. PERF_OVERRUN keeps summing across
+    // frames and clears when read, so sparse polling misses nothing.
+    logic [31:0] frame_count;
+    logic [15:0] tile_cycles, sprite_cycles;        // current line
+    logic [15:0] acc_missed, acc_dropped, acc_max_sprites, acc_tile_max, acc_sprite_max;
+    logic [15:0] perf_missed, perf_dropped, perf_max_sprites, perf_tile_max, perf_sprite_max;
+    logic [15:0] overrun_missed, overrun_dropped;
+    logic        read_d;                            // second cycle of an Avalon read
+    logic        overrun_clear;
+    logic        line_missed;
+
+    assign overrun_clear = chipselect && !write && address == 9'h7 && !read_d;
+    assign line_missed   = swap_line && hcount == 1590 && !(tile_done_s && sprite_done_s);
+
+    always_ff @(posedge clk) begin
+        if (reset) begin
+            frame_count <= 0;
+            tile_cycles <= 0;
+            sprite_cycles <= 0;
+            acc_missed <= 0;
+            acc_dropped <= 0;
+            acc_max_sprites <= 0;
+            acc_tile_max <= 0;
+            acc_sprite_max <= 0;
+            perf_missed <= 0;
+            perf_dropped <= 0;
+            perf_max_sprites <= 0;
+            perf_tile_max <= 0;
+            perf_sprite_max <= 0;
+            overrun_missed <= 0;
+            overrun_dropped <= 0;
+            read_d <= 0;
+        end else begin
+            read_d <= chipselect && !write;
+
+            // Busy time of each engine on this line, in bus clocks as
+            // seen through the done flags' synchronizers
+            if (line_go && draw_start)
+                tile_cycles <= 0;
+            else if (!tile_done_s)
+                tile_cycles <= tile_cycles + 1'b1;
+            if (line_go && draw_start)
+                sprite_cycles <= 0;
+            else if (!sprite_done_s)
+                sprite_cycles <= sprite_cycles + 1'b1;
+
+            if (frame_tick) begin
+                frame_count <= frame_count + 1'b1;
+                perf_missed <= acc_missed;
+                perf_dropped <= acc_dropped;
+                perf_max_sprites <= acc_max_sprites;
+                perf_tile_max <= acc_tile_max;
+                perf_sprite_max <= acc_sprite_max;
+                acc_missed <= 0;
+                acc_dropped <= 0;
+                acc_max_sprites <= 0;
+                acc_tile_max <= 0;
+                acc_sprite_max <= 0;
+            end else begin
+                if (swap_line && hcount == 1590) begin
+                    if (line_missed)
+                        acc_missed <= acc_missed + 1'b1;
+                    if (tile_cycles > acc_tile_max)
+                        acc_tile_max <= tile_cycles;
+                    if (sprite_cycles > acc_sprite_max)
+                        acc_sprite_max <= sprite_cycles;
+                end
+                if (sprite_stat_valid) begin
+                    acc_dropped <= acc_dropped + sprite_stat_dropped;
+                    if (sprite_stat_sprites > acc_max_sprites)
+                        acc_max_sprites <= sprite_stat_sprites;
+                end
+            end
+
+            // Saturating, cleared by reading PERF_OVERRUN
+            if (overrun_clear) begin
+                overrun_missed <= line_missed;
+                overrun_dropped <= sprite_stat_valid ? sprite_stat_dropped : 16'd0;
+            end else begin
+                if (line_missed && overrun_missed != 16'hFFFF)
+                    overrun_missed <= overrun_missed + 1'b1;
+                if (sprite_stat_valid)
+                    overrun_dropped <= (overrun_dropped + sprite_stat_dropped < overrun_dropped) ?
+                                       16'hFFFF : overrun_dropped + sprite_stat_dropped;
+            end
+        end
+    end
+
+    // ------------------- Collision queries -------------------
+    // COLQ_MAP_DATA and COLQ_PROFILE_DATA store at their index register
+    // and move it on, as TILEMAP_DATA does. A COLQ_QUERY write queues a
+    // box; reading COLQ_RESULT takes the oldest answer.
+    logic [12:0] colq_map_idx;
+    logic [7:0]  colq_prof_idx;
+    logic [15:0] colq_bounds;                       // [15:8] height, [7:0] width
+    logic [31:0] colq_result;
+    logic [5:0]  colq_pending;
+    logic [4:0]  colq_results;
+    logic        colq_map_we, colq_prof_we, colq_hazard_we, colq_query_we, colq_pop;
+
+    assign colq_map_we    = chipselect && write && address == 9'h69;
+    assign colq_prof_we   = chipselect && write && address == 9'h6B;
+    assign colq_hazard_we = chipselect && write && address[8:1] == 8'h36;
+    assign colq_query_we  = chipselect && write && address == 9'h6F;
+    assign colq_pop       = chipselect && !write && address == 9'h70 && !read_d;
+
+    collision_query u_collision_query(
+        .clk            (clk),
+        .reset          (reset),
+        .map_wr_en      (colq_map_we),
+        .map_wr_addr    (colq_map_idx),
+        .map_wr_data    (writedata[3:0]),
+        .prof_wr_en     (colq_prof_we),
+        .prof_wr_addr   (colq_prof_idx),
+        .prof_wr_data   (writedata[15:0]),
+        .hazard_wr_en   (colq_hazard_we),
+        .hazard_wr_idx  (address[0]),
+        .hazard_wr_data (writedata),
+        .map_w          (colq_bounds[7:0]),
+        .map_h          (colq_bounds[15:8]),
+        .q_push         (colq_query_we),
+        .q_data         (writedata),
+        .r_pop          (colq_pop),
+        .r_data         (colq_result),
+        .q_pending      (colq_pending),
+        .r_count        (colq_results)
+    );
+
 
 
     vga_counters counters(.clk50(clk), .*);
@@ -120,51 +651,127 @@ module vga_top(input logic        clk,
         if (reset) begin
 			// status_reg <= 0;
 			ctrl_reg <= 0;
-			tile_start <= 0;
-			sprite_start <= 0;
-            wren_tile_disp <= 0;
-            wren_pixel_disp <= 0;
 
             switch <= 0;
+            fine_x_disp <= 0;
+            fg_fine_x_disp <= 0;
+            fg_en_disp <= 0;
+            lowres <= 0;
+            lowres_disp <= 0;
+
+            scroll_reg <= 0;
+            scroll_pending <= 0;
+            map_reg <= {16'd0, 8'd30, 8'd40};
+            map_pending <= {16'd0, 8'd30, 8'd40};
+            fg_scroll_reg <= 0;
+            fg_scroll_pending <= 0;
+            fg_map_reg <= {16'd0, 8'd30, 8'd40};
+            fg_map_pending <= {16'd0, 8'd30, 8'd40};
+            fg_key <= 0;
+            line_scroll_idx <= 0;
+            tilemap_wr_idx <= 0;
+            pattern_wr_idx <= 0;
+            pattern4_wr_idx <= 0;
+            palette_wr_idx <= 0;
+            colq_map_idx <= 0;
+            colq_prof_idx <= 0;
+            colq_bounds <= {8'd30, 8'd40};
+            line_irq_reg <= 0;
+            irq_pending <= 0;
 
             audio_ctrl <= 0;
         end
         else begin
-            if (vcount < 479 || vcount == 524) begin
-                if (hcount == 0) begin
-                    tile_start <= 1;
-                end else begin
-                    tile_start <= 0;
-                end     
-                // sprite start
-                // 60 clk enough to draw tile
-                if (hcount == 60 && tile_done && sprite_done) begin
-                    sprite_start <= 1;
-                end 
-                
-                if (sprite_start) begin // 1 cycle pulse
-                    sprite_start <= 0;
-                end
-
+            if (swap_line) begin
                 // 1 cycle flip "switch", 1 cycle read "switch" to "disp_sel",1 cycle read memory
-                // more cycles to insure robust
-                if (hcount == 1590 && tile_done && sprite_done)
+                // more cycles to insure robust. The draw side sees the
+                // switch through its synchronizer before the next line_go.
+                if (hcount == 1590 && tile_done_s && sprite_done_s) begin
                     switch <= ~switch;
+                    fine_x_disp <= fine_x;
+                    fg_fine_x_disp <= fg_fine_x;
+                    fg_en_disp <= fg_map_reg[31];
+                    lowres_disp <= lowres;
+                end
+            end
+
+            if (frame_tick) begin
+                lowres <= ctrl_reg[2];
+                scroll_reg <= scroll_pending;
+                map_reg <= map_pending;
+                fg_scroll_reg <= fg_scroll_pending;
+                fg_map_reg <= fg_map_pending;
             end
 
+            irq_pending <= (irq_pending & ~((chipselect && write && address == 9'h19) ? writedata[1:0] : 2'b00)) |
+                           {frame_tick, line_hit};
+
             if (chipselect) begin
                 if (write) begin
                     case (address)
-                        6'h0: begin
+                        9'h0: begin
                             ctrl_reg <= writedata;
                             // audio part
                             audio_ctrl <= writedata[31:29];
                         end
+                        9'h8: scroll_pending <= writedata;
+                        9'h9: map_pending <= writedata;
+                        9'hA: line_scroll_idx <= writedata[8:0];
+                        9'hB: line_scroll_idx <= line_scroll_idx + 1'b1;
+                        9'hC: tilemap_wr_idx <= writedata[12:0];
+                        9'hD: tilemap_wr_idx <= tilemap_wr_idx + 1'b1;
+                        9'hE: pattern_wr_idx <= writedata[13:0];
+                        9'hF: pattern_wr_idx <= pattern_wr_idx + 1'b1;
+                        9'h10: palette_wr_idx <= writedata[7:0];
+                        9'h11: palette_wr_idx <= palette_wr_idx + 1'b1;
+                        9'h12: pattern4_wr_idx <= writedata[12:0];
+                        9'h13: pattern4_wr_idx <= pattern4_wr_idx + 1'b1;
+                        9'h15: fg_scroll_pending <= writedata;
+                        9'h16: fg_map_pending <= writedata;
+                        9'h17: fg_key <= writedata[14:0];
+                        9'h18: line_irq_reg <= writedata;
+                        9'h68: colq_map_idx <= writedata[12:0];
+                        9'h69: colq_map_idx <= colq_map_idx + 1'b1;
+                        9'h6A: colq_prof_idx <= writedata[7:0];
+                        9'h6B: colq_prof_idx <= colq_prof_idx + 1'b1;
+                        9'h6E: colq_bounds <= writedata[15:0];
                     endcase
                 end
+                else if (address[8:7] == 2'b11) begin
+                    readdata <= motion_readdata;
+                end
+                else if (address[8:6] == 3'b001 && address[5:0] < 6'h28) begin
+                    readdata <= coll_readdata;
+                end
+                else if (address >= 9'h74 && address <= 9'h7C) begin
+                    readdata <= tear_readdata;
+                end
                 else begin // read
                     case (address)
-                        6'h1: readdata <= status_reg;
+                        9'h1: readdata <= status_reg;
+                        9'h2: readdata <= frame_count;
+                        9'h3: readdata <= {16'd0, perf_missed};
+                        9'h4: readdata <= {16'd0, perf_dropped};
+                        9'h5: readdata <= {16'd0, perf_max_sprites};
+                        9'h6: readdata <= {perf_tile_max, perf_sprite_max};
+                        9'h7: if (!read_d) readdata <= {overrun_dropped, overrun_missed};
+                        9'h8: readdata <= scroll_pending;
+                        9'h9: readdata <= map_pending;
+                        9'hA: readdata <= {23'd0, line_scroll_idx};
+                        9'hC: readdata <= {19'd0, tilemap_wr_idx};
+                        9'hE: readdata <= {18'd0, pattern_wr_idx};
+                        9'h10: readdata <= {24'd0, palette_wr_idx};
+                        9'h12: readdata <= {19'd0, pattern4_wr_idx};
+                        9'h15: readdata <= fg_scroll_pending;
+                        9'h16: readdata <= fg_map_pending;
+                        9'h17: readdata <= {17'd0, fg_key};
+                        9'h18: readdata <= line_irq_reg;
+                        9'h19: readdata <= {30'd0, irq_pending};
+                        9'h68: readdata <= {19'd0, colq_map_idx};
+                        9'h6A: readdata <= {24'd0, colq_prof_idx};
+                        9'h6E: readdata <= {16'd0, colq_bounds};
+                        9'h70: if (!read_d) readdata <= colq_result;
+                        9'h71: readdata <= {19'd0, colq_results, 2'd0, colq_pending};
                     endcase
                 end
             end
@@ -172,12 +779,21 @@ module vga_top(input logic        clk,
         end
     end
  
-    // 1 cycle delay
-    assign addr_pixel_disp = hcount[10:1] < 639 ? hcount[10:1] + 1 : 0;
-    // MSB is transparency bit ( 1 = transparent, 0 = no)
-    assign VGA_R = q_pixel_disp[14:10] << 3;
-    assign VGA_G = q_pixel_disp[9:5] << 3;
-    assign VGA_B = q_pixel_disp[4:0] << 3;
+    // 1 cycle delay; the line buffers hold the line fine_x pixels to the right
+    logic [9:0] disp_x, buf_x;
+    assign disp_x = hcount[10:1] < 639 ? hcount[10:1] + 10'd1 : 10'd0;
+    assign buf_x  = lowres_disp ? {1'b0, disp_x[9:1]} : disp_x;
+    assign addr_pixel_disp    = buf_x + fine_x_disp;
+    assign fg_addr_pixel_disp = buf_x + fg_fine_x_disp;
+
+    // A foreground pixel shows unless it is the key colour, or it is below
+    // sprites (bit 15 clear) and a sprite pixel (bit 15 set) is under it
+    logic [15:0] pixel_out;
+    assign pixel_out = (fg_en_disp && fg_q_pixel_disp[14:0] != fg_key &&
+                        (fg_q_pixel_disp[15] || !q_pixel_disp[15])) ? fg_q_pixel_disp : q_pixel_disp;
+    assign VGA_R = pixel_out[14:10] << 3;
+    assign VGA_G = pixel_out[9:5] << 3;
+    assign VGA_B = pixel_out[4:0] << 3;
     
 
 endmodule
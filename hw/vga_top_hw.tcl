@@ -40,6 +40,8 @@ set_fileset_property QUARTUS_SYNTH TOP_LEVEL vga_top
 set_fileset_property QUARTUS_SYNTH ENABLE_RELATIVE_INCLUDE_PATHS false
 set_fileset_property QUARTUS_SYNTH ENABLE_FILE_OVERWRITE_MODE false
 add_fileset_file vga_top.sv SYSTEM_VERILOG PATH vga_top.sv TOP_LEVEL_FILE
+add_fileset_file cdc.sv SYSTEM_VERILOG PATH cdc.sv
+add_fileset_file render_pll.v VERILOG PATH render_pll.v
 add_fileset_file linebuffer.sv SYSTEM_VERILOG PATH linebuffer.sv
 add_fileset_file linebuffer_ram.v VERILOG PATH linebuffer_ram.v
 add_fileset_file tilemap.v VERILOG PATH tilemap.v
@@ -50,11 +52,19 @@ add_fileset_file tile_pattern.v VERILOG PATH tile_pattern.v
 add_fileset_file sprite_drawer.sv SYSTEM_VERILOG PATH sprite_drawer.sv
 add_fileset_file sprite_engine.sv SYSTEM_VERILOG PATH sprite_engine.sv
 add_fileset_file sprite_frontend.sv SYSTEM_VERILOG PATH sprite_frontend.sv
-add_fileset_file sprite_pattern_rom.v VERILOG PATH sprite_pattern_rom.v
+add_fileset_file sprite_eval.sv SYSTEM_VERILOG PATH sprite_eval.sv
+add_fileset_file sprite_anim.sv SYSTEM_VERILOG PATH sprite_anim.sv
+add_fileset_file sprite_motion.sv SYSTEM_VERILOG PATH sprite_motion.sv
+add_fileset_file sprite_collide.sv SYSTEM_VERILOG PATH sprite_collide.sv
+add_fileset_file collision_query.sv SYSTEM_VERILOG PATH collision_query.sv
+add_fileset_file tear_detect.sv SYSTEM_VERILOG PATH tear_detect.sv
+add_fileset_file sprite_pattern_ram.v VERILOG PATH sprite_pattern_ram.v
+add_fileset_file sprite_pattern4_ram.v VERILOG PATH sprite_pattern4_ram.v
 add_fileset_file tilemap_test.mif MIF PATH tilemap_test.mif
 add_fileset_file tiles_test.mif MIF PATH tiles_test.mif
 add_fileset_file sprite_attr_ram.v VERILOG PATH sprite_attr_ram.v
 add_fileset_file sprites.mif MIF PATH sprites.mif
+add_fileset_file sprites64.mif MIF PATH sprites64.mif
 add_fileset_file sprites_test.mif MIF PATH sprites_test.mif
 
 
@@ -134,7 +144,7 @@ set_interface_property avalon_slave_0 SVD_ADDRESS_GROUP ""
 add_interface_port avalon_slave_0 writedata writedata Input 32
 add_interface_port avalon_slave_0 write write Input 1
 add_interface_port avalon_slave_0 chipselect chipselect Input 1
-add_interface_port avalon_slave_0 address address Input 6
+add_interface_port avalon_slave_0 address address Input 9
 add_interface_port avalon_slave_0 readdata readdata Output 32
 set_interface_assignment avalon_slave_0 embeddedsw.configuration.isFlash 0
 set_interface_assignment avalon_slave_0 embeddedsw.configuration.isMemoryDevice 0
@@ -178,3 +188,21 @@ set_interface_property audio_ctrl SVD_ADDRESS_GROUP ""
 
 add_interface_port audio_ctrl audio_ctrl audio_ctrl Output 3
 
+
+# 
+# connection point interrupt_sender
+# 
+add_interface interrupt_sender interrupt end
+set_interface_property interrupt_sender associatedAddressablePoint avalon_slave_0
+set_interface_property interrupt_sender associatedClock clock
+set_interface_property interrupt_sender associatedReset reset
+set_interface_property interrupt_sender bridgedReceiverOffset ""
+set_interface_property interrupt_sender bridgesToReceiver ""
+set_interface_property interrupt_sender ENABLED true
+set_interface_property interrupt_sender EXPORT_OF ""
+set_interface_property interrupt_sender PORT_NAME_MAP ""
+set_interface_property interrupt_sender CMSIS_SVD_VARIABLES ""
+set_interface_property interrupt_sender SVD_ADDRESS_GROUP ""
+
+add_interface_port interrupt_sender irq irq Output 1
+
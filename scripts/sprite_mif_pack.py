@@ -0,0 +1,94 @@
+"""Pack the 16-bit sprite MIF into 64-bit words for the sprite pattern ROM.
+
+Every four consecutive pixels of a sprite row become one ROM word, first
+pixel in the low 16 bits. Usage:
+
+    python3 sprite_mif_pack.py hw/sprites.mif hw/sprites64.mif
+
+With a .bin destination, writes a sprite bank for load_sprite_bank()
+instead: raw little-endian pixels, 256 per frame, optionally only the
+frames first..first+count-1:
+
+    python3 sprite_mif_pack.py hw/sprites.mif level2.bin [first count]
+
+With --4bpp, writes an indexed bank for load_sprite_bank4(): the frames'
+colours become one 15-colour palette (16 little-endian RGB555 entries,
+entry 0 transparent), followed by 128 bytes per frame, left pixel in the
+low nibble. Fails if the frames use more than 15 colours:
+
+    python3 sprite_mif_pack.py --4bpp hw/sprites.mif sparks.bin 65 3
+"""
+import struct
+import sys
+
+TRANSPARENT = 0x8000
+
+
+def read_mif(path):
+    words = {}
+    depth = 0
+    in_data = False
+    with open(path, "r", encoding="utf-8", errors="replace") as f:
+        for line in f:
+            line = line.strip()
+            if line.startswith("DEPTH"):
+                depth = int(line.split("=")[1].strip(" ;"))
+            elif "BEGIN" in line:
+                in_data = True
+            elif in_data and ":" in line and ";" in line:
+                addr, value = line.rstrip(";").split(":")
+                words[int(addr, 16)] = int(value, 16)
+    return depth, words
+
+
+def pack(src, dst):
+    depth, words = read_mif(src)
+    depth64 = (depth + 3) // 4
+    with open(dst, "w") as out:
+        out.write("-- Generated from %s by scripts/sprite_mif_pack.py, do not edit.\n" % src.split("/")[-1])
+        out.write("-- 4 pixels per word, pixel 0 in bits [15:0]; 64 words per 16x16 frame.\n\n")
+        out.write("WIDTH=64;\nDEPTH=%d;\nADDRESS_RADIX=HEX;\nDATA_RADIX=HEX;\nCONTENT BEGIN\n" % depth64)
+        for a in range(depth64):
+            value = 0
+            for i in range(4):
+                value |= words.get(4 * a + i, TRANSPARENT) << (16 * i)
+            out.write("%04X: %016X;\n" % (a, value))
+        out.write("END;\n")
+
+
+def bank(src, dst, first=0, count=None):
+    depth, words = read_mif(src)
+    if count is None:
+        count = depth // 256 - first
+    with open(dst, "wb") as out:
+        for p in range(256 * first, 256 * (first + count)):
+            out.write(struct.pack("<H", words.get(p, TRANSPARENT)))
+
+
+def bank4(src, dst, first=0, count=None):
+    depth, words = read_mif(src)
+    if count is None:
+        count = depth // 256 - first
+    pixels = [words.get(p, TRANSPARENT) for p in range(256 * first, 256 * (first + count))]
+    colors = sorted({p for p in pixels if not p & TRANSPARENT})
+    if len(colors) > 15:
+        sys.exit("%d colours in frames %d-%d, 15 fit in a palette" % (len(colors), first, first + count - 1))
+    palette = [0] + colors + [0] * (15 - len(colors))
+    index = {c: i + 1 for i, c in enumerate(colors)}
+    nibbles = [0 if p & TRANSPARENT else index[p] for p in pixels]
+    with open(dst, "wb") as out:
+        out.write(struct.pack("<16H", *palette))
+        out.write(bytes(nibbles[i] | (nibbles[i + 1] << 4) for i in range(0, len(nibbles), 2)))
+
+
+if __name__ == "__main__":
+    if len(sys.argv) in (4, 6) and sys.argv[1] == "--4bpp":
+        bank4(sys.argv[2], sys.argv[3], *[int(a) for a in sys.argv[4:]])
+        sys.exit(0)
+    if len(sys.argv) not in (3, 5):
+        print(__doc__)
+        sys.exit(1)
+    if sys.argv[2].endswith(".bin"):
+        bank(sys.argv[1], sys.argv[2], *[int(a) for a in sys.argv[3:]])
+    else:
+        pack(sys.argv[1], sys.argv[2])
@@ -0,0 +1,96 @@
+"""Fold flipped duplicate tiles into one pattern with flip bits in the map.
+
+Reads the tile pattern MIF (16 rows of 16 RGB555 pixels per tile, one row
+per 256-bit word) and the tilemap MIF, keeps one pattern for every set of
+tiles that are H, V or HV flips of each other, drops tiles the map never
+uses, and writes both files back out with 16-bit map entries
+([9] vflip, [8] hflip, [7:0] tile). Tiles keep their order, so the id map
+printed at the end is all software needs to follow. Usage:
+
+    python3 tile_fold.py hw/tiles.mif hw/tilemap.mif tiles_out.mif tilemap_out.mif
+"""
+import sys
+
+HFLIP = 1 << 8
+VFLIP = 1 << 9
+
+
+def read_mif(path):
+    words = {}
+    width = depth = 0
+    in_data = False
+    with open(path, "r", encoding="utf-8", errors="replace") as f:
+        for line in f:
+            line = line.split("//")[0].split("--")[0].strip()
+            if line.startswith("WIDTH"):
+                width = int(line.split("=")[1].strip(" ;"))
+            elif line.startswith("DEPTH"):
+                depth = int(line.split("=")[1].strip(" ;"))
+            elif "BEGIN" in line:
+                in_data = True
+            elif in_data and ":" in line and ";" in line:
+                addr, value = line.rstrip(";").split(":")
+                words[int(addr, 16)] = int(value, 16)
+    return width, depth, words
+
+
+def hflip_row(row):
+    out = 0
+    for p in range(16):
+        out |= ((row >> (16 * p)) & 0xFFFF) << (16 * (15 - p))
+    return out
+
+
+def orientations(tile):
+    """The tile as stored for each flip setting, keyed by the entry's flip bits."""
+    h = tuple(hflip_row(r) for r in tile)
+    return {0: tile, VFLIP: tile[::-1], HFLIP: h, HFLIP | VFLIP: h[::-1]}
+
+
+def fold(tiles_src, map_src, tiles_dst, map_dst):
+    _, tile_depth, rows = read_mif(tiles_src)
+    _, map_depth, entries = read_mif(map_src)
+    tiles = [tuple(rows.get(16 * t + r, 0) for r in range(16)) for t in range(tile_depth // 16)]
+    used = sorted({entries.get(a, 0) & 0xFF for a in range(map_depth)})
+
+    kept = []           # patterns written out
+    lookup = {}         # oriented pattern -> (new id, flip bits that give it)
+    remap = {}          # old id -> new entry
+    for t in used:
+        if tiles[t] in lookup:
+            remap[t] = lookup[tiles[t]][0] | lookup[tiles[t]][1]
+            continue
+        new = len(kept)
+        kept.append(tiles[t])
+        for flips, pattern in orientations(tiles[t]).items():
+            lookup.setdefault(pattern, (new, flips))
+        remap[t] = new
+
+    with open(tiles_dst, "w") as out:
+        out.write("WIDTH=256;\nDEPTH=%d;\nADDRESS_RADIX=HEX;\nDATA_RADIX=HEX;\nCONTENT BEGIN\n" % (16 * len(kept)))
+        for t, tile in enumerate(kept):
+            for r, row in enumerate(tile):
+                out.write("%04X: %064X;\n" % (16 * t + r, row))
+        out.write("END;\n")
+    with open(map_dst, "w") as out:
+        out.write("WIDTH=16;\nDEPTH=%d;\nADDRESS_RADIX=HEX;\nDATA_RADIX=HEX;\nCONTENT BEGIN\n" % map_depth)
+        for a in range(map_depth):
+            # flips already in the entry compose with the fold's
+            e = entries.get(a, 0)
+            out.write("%04X : %04X;\n" % (a, ((e & 0xFF00) ^ remap[e & 0xFF]) & 0xFFFF))
+        out.write("END;\n")
+
+    print("%d tiles, %d used, %d folded into another: %d patterns, %d rows"
+          % (len(tiles), len(used), len(used) - len(kept), len(kept), 16 * len(kept)))
+    for t in used:
+        if remap[t] != t:
+            print("  %3d -> %3d%s%s" % (t, remap[t] & 0xFF,
+                                        " hflip" if remap[t] & HFLIP else "",
+                                        " vflip" if remap[t] & VFLIP else ""))
+
+
+if __name__ == "__main__":
+    if len(sys.argv) != 5:
+        print(__doc__)
+        sys.exit(1)
+    fold(*sys.argv[1:])
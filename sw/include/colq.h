@@ -0,0 +1,45 @@
+#ifndef COLQ_H
+#define COLQ_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "type.h"
+
+// Collision queries: the one-column terrain probe of is_tile_blocked() and
+// is_death(), answered for a batch of boxes at once. The hardware query unit
+// holds the level as one class per tile (its tile type) with a 16x16 blocked
+// profile per class; colq_query_sw() walks the same tables, so both paths
+// give the same results.
+#define COLQ_BATCH 16 // Boxes per hardware round trip
+
+// Result hazard bits: the probe crossed a tile deadly to that player
+#define COLQ_HAZARD_FIREBOY 0x1
+#define COLQ_HAZARD_WATERGIRL 0x2
+
+typedef struct
+{
+    uint16_t x, y; // Top left pixel, up to 1023
+    uint8_t w, h;  // Probes column x + w / 2 over rows y .. y + h - 1; both < 64
+} colq_box_t;
+
+typedef struct
+{
+    bool blocked;     // A probed row is solid or outside the map
+    uint8_t hazard;   // COLQ_HAZARD_* of the tiles probed before leaving the map
+    uint16_t surface; // First blocked row, when blocked
+} colq_result_t;
+
+// Build the tables from the level map and load them into the hardware;
+// queries are answered in software if the unit can't be loaded (level load)
+void colq_load(void);
+
+// The box probed by is_tile_blocked(x, y, width, height) and is_death()
+colq_box_t colq_player_box(float x, float y, float width, float height);
+
+// Answer `count` boxes, in hardware when it is available
+void colq_query(const colq_box_t *boxes, colq_result_t *results, int count);
+
+// Software answer from the same tables
+void colq_query_sw(const colq_box_t *boxes, colq_result_t *results, int count);
+
+#endif // COLQ_H
@@ -2,6 +2,7 @@
 #define HW_INTERACT_H
 
 #include <stdint.h>
+#include "vga_top.h"
 
 extern int vga_top_fd;
 
@@ -15,16 +16,181 @@ void set_map_and_audio(uint8_t tilemap_idx,
                        uint8_t bgm_on,
                        uint8_t sfx_sel);
 
+// 320 x 240 mode: 8 x 8 tiles, and sprite, scroll and line scroll
+// coordinates in low resolution pixels and rows. Takes effect at the next
+// vblank; the other CTRL_REG bits keep their last written value, and
+// set_map_and_audio() keeps this one.
+#define CTRL_LOWRES (1u << 2)
+void set_lowres(uint8_t on);
+
 void write_sprite(uint8_t index,
                   uint8_t enable, uint8_t flip,
                   uint16_t x, uint16_t y,
                   uint8_t frame);
 
+void write_sprite_attr(uint8_t index, uint32_t attr_word);
+
+// Writing an animation word restarts that slot's animation at step 0
+void write_sprite_anim(uint8_t index, uint32_t anim_word);
+
 void read_status(unsigned *col, unsigned *row);
 
-uint32_t make_attr_word(uint8_t enable, uint8_t flip,
-                        uint16_t x, uint16_t y,
-                        uint8_t frame);
+void wait_for_vblank(void);
+
+// Frames that went by unseen between wait_for_vblank() calls since the
+// last call; 0 while the driver has no raster interrupt
+unsigned frames_missed(void);
+
+// Raise VGA_TOP_EVENT_LINE when the beam reaches `line` (0-524). Returns 0
+// on success.
+int write_line_irq(uint8_t enable, uint16_t line);
+
+// Sleep until one of `events` (VGA_TOP_EVENT_*) fires. Returns the events
+// that fired and sets *frame_count, or -1 (errno ENODEV: no interrupt).
+int wait_raster_event(uint8_t events, uint32_t *frame_count);
+
+// Write the words of a motion channel selected by arg->write_mask, or read
+// all of them back. Return 0 on success.
+int write_motion(const vga_top_motion_arg_t *arg);
+int read_motion(vga_top_motion_arg_t *arg);
+
+// Background scroll: the map pixel shown at the screen's top left.
+// Takes effect at the next vblank, so it can be written any time.
+void write_scroll(uint16_t x, uint16_t y);
+
+// Map size in tiles (up to 128 x 64, at least 30 rows) and whether each
+// line takes its scroll from the line scroll table. Returns 0 on success.
+int write_map_size(uint8_t width, uint8_t height, uint8_t line_scroll);
+
+// Load `count` line scroll entries (make_scroll_word) starting at line
+// `first`. Call during vblank. Returns 0 on success.
+int write_line_scroll(uint16_t first, uint16_t count, const uint32_t *entries);
+
+// Foreground plane: a second map of width x height entries starting at
+// tilemap entry `base`, drawn over the background with `key` (RGB555) as
+// its transparent colour. Both calls take effect at the next vblank.
+// write_fg_map returns 0 on success.
+void write_fg_scroll(uint16_t x, uint16_t y);
+int write_fg_map(uint8_t enable, uint8_t width, uint8_t height, uint16_t base, uint16_t key);
+
+// Tilemap entry flags, OR'd onto the tile id. TILE_PRIORITY draws a
+// foreground tile over the sprites; the background is always below them.
+#define TILE_HFLIP (1u << 8)
+#define TILE_VFLIP (1u << 9)
+#define TILE_PRIORITY (1u << 15)
+
+// Write `count` tilemap entries into map `map` (or VGA_TOP_MAP_FG) starting
+// at cell `cell` (row * width + col, for the size last set with
+// write_map_size or write_fg_map), e.g. a whole
+// 40x30 level with write_tilemap(map, 0, 1200, tiles). Returns 0 on success.
+int write_tilemap(uint8_t map, uint16_t cell, uint16_t count, const uint16_t *tiles);
+
+// Tile animation entry `index` (0-15): every map entry showing tile `base`
+// cycles through tiles base .. base + frames - 1, one step every `vblanks`
+// vblanks, with no map writes. Returns 0 on success.
+int write_tile_anim(uint8_t index, uint8_t enable, uint8_t base, uint8_t frames, uint8_t vblanks);
+
+// Overwrite `count` 16x16 sprite frames (0-127) starting at `frame` with
+// RGB555 pixels (bit 15 = transparent), 256 per frame, row-major. Frames
+// being displayed change mid-frame, so call during loads or vblank.
+// Returns 0 on success.
+int write_sprite_frames(uint8_t frame, uint16_t count, const uint16_t *pixels);
+
+// Load a sprite bank file (raw little-endian frames, as written by
+// scripts/sprite_mif_pack.py) into the frames from `frame` on.
+// Returns the number of frames loaded, or -1 on error.
+int load_sprite_bank(const char *path, uint8_t frame);
+
+// Indexed (4 bpp) frames: 128 bytes per frame, two pixels per byte, the
+// left one in the low nibble; index 0 is transparent. Same timing rules
+// as write_sprite_frames. Returns 0 on success.
+int write_sprite_frames4(uint8_t frame, uint16_t count, const uint8_t *packed);
+
+// Load an indexed bank file (16 RGB555 palette entries, then packed frames,
+// as written by scripts/sprite_mif_pack.py) into palette `palette` and the
+// indexed frames from `frame` on. Returns the number of frames loaded, or
+// -1 on error.
+int load_sprite_bank4(const char *path, uint8_t frame, uint8_t palette);
+
+// Set palette `palette` (0-15); colors[0] is unused. Recolours every
+// indexed sprite drawn with it from the next line on.
+void write_palette(uint8_t palette, const uint16_t colors[16]);
+
+// Palette used by hardware sprite slot `index` when its frame is indexed
+void write_sprite_palette(uint8_t index, uint8_t palette);
+
+// Mark which tile ids (bit id % 32 of mask[id / 32]) are hazards for the
+// hardware sprite-tile collision flags. Returns 0 on success.
+int write_hazard_tiles(const uint32_t mask[8]);
+
+// Collision flags of the last complete frame: per sprite slot, whether it
+// touched another sprite or a hazard tile on an opaque pixel, and for
+// slots 0-7 which slots they touched. Returns 0 on success.
+int read_collision(vga_top_collision_arg_t *coll);
+
+static inline int collision_bit(const __u32 mask[4], uint8_t slot)
+{
+    return (mask[slot / 32] >> (slot % 32)) & 1;
+}
+
+// Collision query unit: load the class of `count` map cells from `cell`
+// on, in a map of the size last given to write_colq_classes, then the
+// per-class blocked profiles and hazard bits. Return 0 on success.
+int write_colq_map(uint16_t cell, uint16_t count, const uint8_t *classes);
+int write_colq_classes(const vga_top_colq_classes_arg_t *classes);
+
+// Run up to VGA_TOP_COLQ_BATCH packed queries and fetch their packed
+// results. Returns 0 on success.
+int colq_query_batch(const uint32_t *query, uint32_t *result, uint8_t count);
+
+// Sprite attribute writes of the last frame that landed during active
+// display, and which of them hit the sprite while it was being drawn.
+// Returns 0 on success.
+int read_tear(vga_top_tear_arg_t *tear);
+
+// Read the display pipeline counters; also clears the overrun totals.
+// Returns 0 on success.
+int read_perf(vga_top_perf_arg_t *perf);
+
+// OR into an attribute word to draw frame_id from the indexed store
+#define SPRITE_ATTR_INDEXED (1u << 29)
+
+static inline uint32_t make_attr_word(uint8_t enable, uint8_t flip,
+                                      uint8_t size,
+                                      uint16_t x, uint16_t y,
+                                      uint8_t frame)
+{
+    return ((uint32_t)(enable & 1) << 31) |
+           ((uint32_t)(flip & 1) << 30) |
+           ((uint32_t)(size & 3) << 27) |
+           ((uint32_t)(y & 0x1FF) << 18) |
+           ((uint32_t)(x & 0x3FF) << 8) |
+           (frame & 0xFF);
+}
+
+// Hardware frame animation: frame_id becomes base + step, advanced every
+// `period` vblanks through `count` sprites (wrapping, or ping-pong).
+// OR in make_motion_link() to draw the sprite relative to a motion channel.
+static inline uint32_t make_anim_word(uint8_t enable, uint8_t pingpong,
+                                      uint8_t base, uint8_t count,
+                                      uint8_t period)
+{
+    return ((uint32_t)(enable & 1) << 31) |
+           ((uint32_t)(pingpong & 1) << 30) |
+           ((uint32_t)base << 16) |
+           ((uint32_t)count << 8) |
+           period;
+}
+
+static inline uint32_t make_scroll_word(uint16_t x, uint16_t y)
+{
+    return ((uint32_t)(y & 0x3FF) << 16) | (x & 0x7FF);
+}
+
+static inline uint32_t make_motion_link(uint8_t channel)
+{
+    return (1u << 29) | ((uint32_t)(channel & 0xF) << 25);
+}
 
 #endif // HW_INTERACT_H
 
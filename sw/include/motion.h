@@ -0,0 +1,40 @@
+#ifndef MOTION_H
+#define MOTION_H
+
+#include <stdint.h>
+#include "type.h"
+
+// Hardware motion channels. A linked sprite is drawn at its own x/y plus the
+// channel position, and the channel moves by itself once per vblank.
+#define NUM_MOTION_CHANNELS 16
+#define MOTION_FRAC_BITS 6 // Positions and velocities are in 1/64 pixel
+
+typedef enum
+{
+    MOTION_FREE = 0,  // No bounds
+    MOTION_STOP,      // Stop at the bounds
+    MOTION_BOUNCE,    // Reverse at the bounds
+    MOTION_OSCILLATE, // Swing about the middle of the bounds
+} motion_mode_t;
+
+// Free every channel and stop it (level load)
+void motion_reset(void);
+
+// Claim a channel, -1 when all are in use
+int8_t motion_alloc(void);
+
+// Place the channel at (x, y) at rest, set its bounds and modes and enable it
+void motion_setup(int8_t ch, float x, float y,
+                  motion_mode_t mode_x, float min_x, float max_x,
+                  motion_mode_t mode_y, float min_y, float max_y);
+
+// Change the velocity in pixels per vblank; nothing is written when unchanged
+void motion_set_velocity(int8_t ch, float vx, float vy);
+
+// Read the current position back from the hardware
+void motion_read(int8_t ch, float *x, float *y);
+
+// Last known whole-pixel position, without touching the hardware
+void motion_origin(int8_t ch, int *x, int *y);
+
+#endif // MOTION_H
@@ -0,0 +1,30 @@
+#ifndef PARTICLE_H
+#define PARTICLE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "type.h"
+
+// Clear all particles and rebuild the tile collision grid and hazard list
+void particle_init(void);
+
+// Spawn one particle centred at (x, y); returns false when the buffers are full
+bool particle_emit(float x, float y, float vx, float vy,
+                   uint16_t life, uint8_t frame, particle_prio_t prio);
+
+// Spawn `count` particles flying outward from (x, y)
+void particle_burst(float x, float y, int count, uint8_t frame, particle_prio_t prio);
+
+// Occasionally throw sparks off fire tiles and splashes off water tiles
+void particle_spawn_hazards(void);
+
+// Integrate, collide against the tile grid and remove dead particles
+void particle_update(void);
+
+// Fill `words` with attribute words of on-screen particles, highest
+// priority first. Used by sprite_commit() for the slots left over.
+int particle_sprite_candidates(uint32_t *words, int max);
+
+int particle_count(void);
+
+#endif // PARTICLE_H
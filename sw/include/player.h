@@ -6,9 +6,7 @@
 #include "sprite.h"
 #include "type.h"
 
-void player_init(player_t *p, int x, int y,
-                 uint8_t upper_index, uint8_t lower_index,
-                 player_type_t type);
+void player_init(player_t *p, int x, int y, player_type_t type);
 
 int get_frame_count(player_t *p, bool is_upper);
 
@@ -32,23 +32,57 @@ extern box_t boxes[NUM_BOXES]; // Tells the compiler that boxes[] is a global de
 // Box (4 frames)
 #define BOX_FRAME ((uint8_t)61) // 0x3D00 >> 8 = 61
 
-// Initialize sprite, set index and frame count
-void sprite_set(sprite_t *s, uint8_t index, uint8_t frame_count);
+// Forget all registered sprites (level load); every hardware slot is rewritten at the next sprite_commit()
+void sprite_pool_reset(void);
+
+// Particles (1 frame each)
+#define PARTICLE_SPARK_FRAME ((uint8_t)65)   // 0x4100 >> 8 = 65
+#define PARTICLE_SPLASH_FRAME ((uint8_t)66)  // 0x4200 >> 8 = 66
+#define PARTICLE_SPARKLE_FRAME ((uint8_t)67) // 0x4300 >> 8 = 67
+
+// Initialize sprite, register it in the pool with its priority class and set frame count
+void sprite_set(sprite_t *s, sprite_prio_t priority, uint8_t frame_count);
+
+// Let the hardware cycle `count` frames from `base`, one step every `period`
+// vblanks; count <= 1 shows `base` still. Only a changed setting restarts it.
+void sprite_set_anim(sprite_t *s, uint8_t base, uint8_t count,
+                     uint8_t period, bool pingpong);
 
 // Frame cycle update (frame_id++)
 void sprite_animate(sprite_t *s);
 
 void item_update_sprite(item_t *item);
 
-// Write to VGA
+// Stage current position/frame for the next sprite_commit()
 void sprite_update(sprite_t *s);
 
+// Assign hardware slots by priority, cull hidden/off-screen sprites, enforce the
+// per-scanline budget and write changed slots. Call once per frame during vblank.
+// Leftover slots go to particles. Returns the number of gameplay sprites dropped.
+int sprite_commit(void);
+
 // Turn off display
 void sprite_clear(sprite_t *s);
 
-void item_init(item_t *item, float x, float y, uint8_t sprite_index, uint8_t frame_id);
-
-void box_init(box_t *b, int tile_x, int tile_y, int sprite_base_index, uint8_t frame_id);
+// Reserve pool sprites for every piece of `def` and stage them at (x, y)
+void metasprite_init(metasprite_t *ms, const metasprite_def_t *def,
+                     sprite_prio_t priority, uint8_t base_frame,
+                     uint16_t x, uint16_t y);
+// Swap the piece layout, e.g. for a state change; must not need more pieces than at init
+void metasprite_set_def(metasprite_t *ms, const metasprite_def_t *def);
+// Restage every piece with one call
+void metasprite_move(metasprite_t *ms, uint16_t x, uint16_t y);
+void metasprite_set_flip(metasprite_t *ms, bool flip);
+void metasprite_show(metasprite_t *ms, bool enable);
+
+// Draw the sprite at the position of motion channel `ch` (see motion.h); its
+// own x/y become an offset from the channel and start at 0
+void sprite_link_motion(sprite_t *s, int8_t ch);
+void metasprite_link_motion(metasprite_t *ms, int8_t ch);
+
+void item_init(item_t *item, float x, float y, uint8_t frame_id);
+
+void box_init(box_t *b, int tile_x, int tile_y, uint8_t frame_id);
 void box_try_push(box_t *box, const player_t *player);
 void box_update_position(box_t *box, player_t *players);
 void box_update_sprite(box_t *b);
@@ -57,14 +91,14 @@ bool is_box_blocked(float x, float y, float w, float h);
 bool check_overlap(float x1, float y1, float w1, float h1,
                    float x2, float y2, float w2, float h2);
 
-void lever_init(lever_t *lvr, float tile_x, float tile_y, uint8_t sprite_index_base);
+void lever_init(lever_t *lvr, float tile_x, float tile_y);
 void lever_update(lever_t *lvr, const player_t *players);
 
-void elevator_init(elevator_t *elv, float tile_x, float tile_y, float min_tile_y, float max_tile_y, uint8_t sprite_index_base, uint8_t frame_index);
+void elevator_init(elevator_t *elv, float tile_x, float tile_y, float min_tile_y, float max_tile_y, uint8_t frame_index);
 bool is_elevator_blocked(float x, float y, float w, float h, float *vy_out);
 void elevator_update(elevator_t *elv, bool go_up, player_t *players);
 
-void button_init(button_t *btn, float tile_x, float tile_y, uint8_t sprite_index_base);
+void button_init(button_t *btn, float tile_x, float tile_y);
 
 void button_update(button_t *btn, const player_t *players);
 
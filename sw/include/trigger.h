@@ -0,0 +1,14 @@
+#ifndef TRIGGER_H
+#define TRIGGER_H
+
+#include "type.h"
+
+// Build the sensor/actuator graph for the current level. Call after the
+// levers, buttons and elevators it references have been initialized.
+void trigger_load(const trigger_link_t *links, int count);
+
+// Evaluate sensors near a player (plus any still engaged), send edge
+// events to linked actuators, and step the actuators that are awake
+void trigger_update(player_t *players);
+
+#endif // TRIGGER_H
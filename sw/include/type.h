@@ -8,6 +8,8 @@
 
 #define NUM_ITEMS 6
 #define VACTIVE 480
+#define VTOTAL 525
+#define LINE_TIME_NS 32000 // 1600 cycles of the 50 MHz clock per scanline
 #define NUM_BOXES 1
 #define NUM_LEVERS 1
 #define NUM_ELEVATORS 2
@@ -36,19 +38,122 @@
 
 #define PLAYER_NONE -1
 
+// === trigger graph ===
+#define MAX_TRIGGER_LINKS 16
+#define MAX_SENSORS (NUM_LEVERS + NUM_BUTTONS)
+#define MAX_ACTUATORS NUM_ELEVATORS
+#define SENSOR_WAKE_MARGIN 16 // Pixels around a sensor in which a player wakes it
+
+// === particles ===
+#define MAX_PARTICLES 10240         // SoA capacity, sized for the benchmark
+#define MAX_PARTICLE_SPRITES 128    // Candidates offered to the slot allocator per frame
+#define PARTICLE_GRAVITY 0.15f
+#define PARTICLE_DRAG 0.98f
+#define PARTICLE_BOUNCE 0.4f
+
+// === sprite slot allocation ===
+#define NUM_HW_SPRITES 128       // Entries in the FPGA sprite attribute table
+#define SPRITE_POOL_SIZE 64      // Logical sprites that can be registered at once
+#define SPRITE_BAND_SHIFT 3      // Scanline bands of 8 lines for the per-line budget
+#define NUM_SPRITE_BANDS (VACTIVE >> SPRITE_BAND_SHIFT)
+#define SPRITE_LINE_BUDGET 64    // sprite_eval lists at most MAX_PER_LINE per line
+
+// === game flow (durations in frames) ===
+#define LEVEL_INTRO_FRAMES 30
+#define DEATH_FRAMES 60
+#define LEVEL_COMPLETE_FRAMES 90
+
 ////////////////////////////////////type///////////////////////////////////////////////////////
+// === game_state_t ===
+typedef enum
+{
+    GAME_ATTRACT,       // Logo screen, waiting for any input
+    GAME_LEVEL_INTRO,   // Level loaded, players frozen
+    GAME_PLAY,          // Normal gameplay
+    GAME_DEATH,         // A player died, death sound playing
+    GAME_LEVEL_COMPLETE // Both players reached their goals
+} game_state_t;
+
+// === sprite_prio_t ===
+// Allocation order when hardware slots or scanline budget run out, most critical first
+typedef enum
+{
+    SPRITE_PRIO_PLAYER = 0,
+    SPRITE_PRIO_MECHANISM, // Boxes, elevators, levers, buttons
+    SPRITE_PRIO_ITEM,      // Gems and pickups
+    SPRITE_PRIO_EFFECT,    // Decoration that may flicker or vanish
+    NUM_SPRITE_PRIOS
+} sprite_prio_t;
+
+// === particle_prio_t ===
+// Which particles win the leftover sprite slots, most important first
+typedef enum
+{
+    PARTICLE_PRIO_BURST = 0, // Feedback for player actions (gem pickup)
+    PARTICLE_PRIO_AMBIENT,   // Sparks and splashes on hazard tiles
+    NUM_PARTICLE_PRIOS
+} particle_prio_t;
+
+// === sprite_size_t ===
+// Attribute size field; larger sprites draw consecutive frames, row-major
+typedef enum
+{
+    SPRITE_16x16 = 0,
+    SPRITE_32x16 = 1, // frame, frame + 1 side by side
+    SPRITE_16x32 = 2, // frame over frame + 1
+    SPRITE_32x32 = 3, // frame, frame + 1 over frame + 2, frame + 3
+} sprite_size_t;
+
+#define SPRITE_SIZE_WIDE 0x1
+#define SPRITE_SIZE_TALL 0x2
+
 // === sprite_t ===
 typedef struct
 {
-    uint8_t index;
+    uint8_t index; // Logical id in the sprite pool, not a hardware slot
+    uint8_t priority;
     uint8_t frame_id;
     uint8_t flip;
+    uint8_t size;  // sprite_size_t
+    int8_t motion; // Linked motion channel, -1 for none
+    bool indexed;    // frame_id is a 4 bpp frame drawn through `palette`
+    uint8_t palette; // 0-15
     uint16_t x, y;
     bool enable;
     uint8_t frame_count;
     uint8_t frame_start;
 } sprite_t;
 
+// === metasprite ===
+// One hardware sprite of a compound object, relative to the object's origin
+typedef struct
+{
+    int8_t dx, dy;
+    uint8_t frame; // Offset from the instance's base frame
+    uint8_t flip;
+    uint8_t size;  // sprite_size_t, 16x16 when left out
+} metasprite_piece_t;
+
+// Static layout shared by every object of a type
+typedef struct
+{
+    uint8_t count;
+    uint8_t width; // Bounding width, used to mirror dx when flipped
+    const metasprite_piece_t *pieces;
+} metasprite_def_t;
+
+typedef struct
+{
+    const metasprite_def_t *def;
+    uint8_t first;      // First of `count` consecutive logical sprites in the pool
+    uint8_t count;      // Pieces reserved, may exceed def->count after a def swap
+    uint8_t base_frame;
+    uint16_t x, y;
+    bool flip;
+    bool enable;
+    int8_t motion; // Linked motion channel, -1 for none
+} metasprite_t;
+
 // === item_owner_t ===
 typedef enum
 {
@@ -81,7 +186,7 @@ typedef struct
     float x, y;
     float vx;
     bool active;
-    sprite_t sprites[4];
+    metasprite_t body;
     player_type_t pushing_player_type;
 } box_t;
 
@@ -108,8 +213,6 @@ typedef struct player_t
     sprite_t upper_sprite;
     sprite_t lower_sprite;
 
-    int frame_timer;
-    int frame_index;
     bool was_on_slope_last_frame;
 } player_t;
 
@@ -135,13 +238,7 @@ typedef struct
 {
     float x, y;               //
     bool activated;           //
-    uint8_t base_frame[2];    //
-    uint8_t handle_frames[3]; //
-    sprite_t base_sprites[4]; //
-    // sprite_t handle_sprite;   //
-    sprite_t handle_sprite_left;
-    sprite_t handle_sprite_right;
-    int sprite_base_index;           //
+    metasprite_t body;        // Base and handle, def swapped on toggle
     bool left_entered[NUM_PLAYERS];  //
     bool right_entered[NUM_PLAYERS]; //
 } lever_t;
@@ -153,25 +250,42 @@ typedef struct
     float min_y, max_y;    //
     bool moving_up;        //
     bool active;           //
-    sprite_t sprites[4];   //
-    int sprite_base_index; //
+    metasprite_t body;     //
 } elevator_t;
 
 typedef struct
 {
     float x, y; //
     sprite_t top_sprite;
-    sprite_t base_left_sprite;
-    sprite_t base_right_sprite;
+    metasprite_t base;
 
-    uint8_t sprite_index_base;
     uint8_t frame_top;
-    uint8_t frame_base_left;
-    uint8_t frame_base_right;
     float press_offset; //
     bool pressed;       //
 } button_t;
 
+// === trigger graph ===
+typedef enum
+{
+    SENSOR_LEVER,  // levers[i].activated, latches
+    SENSOR_BUTTON  // buttons[i].pressed, pressure plate
+} sensor_kind_t;
+
+typedef enum
+{
+    ACTUATOR_ELEVATOR // elevators[i] rises while any linked sensor is on
+} actuator_kind_t;
+
+// One edge of the level's wiring: sensor -> actuator. An actuator
+// with several links is driven by the OR of its sensors.
+typedef struct
+{
+    uint8_t sensor_kind;
+    uint8_t sensor;
+    uint8_t actuator_kind;
+    uint8_t actuator;
+} trigger_link_t;
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 
 extern player_t players[NUM_PLAYERS];
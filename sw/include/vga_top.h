@@ -15,9 +15,181 @@ typedef struct
 } vga_top_status_arg_t;
 typedef struct
 {
-	__u8 index;		 /* 0-31                              */
+	__u8 index;		 /* 0-127                             */
 	__u32 attr_word; /* packed sprite attribute (see spec)*/
 } vga_top_sprite_arg_t;
+typedef struct
+{
+	__u8 index;		 /* 0-127                             */
+	__u32 anim_word; /* enable, ping-pong, base, count, vblanks per step */
+} vga_top_anim_arg_t;
+typedef struct
+{
+	__u8 channel;	 /* 0-15                              */
+	__u8 write_mask; /* WRITE_MOTION: VGA_TOP_MOTION_* words to write */
+	__u32 ctrl;		 /* enable, y mode, x mode            */
+	__u32 pos;		 /* y:x, 10.6 fixed point             */
+	__u32 vel;		 /* dy:dx, signed 1/64 px per vblank  */
+	__u32 bound_x;	 /* max:min, 10.6                     */
+	__u32 bound_y;	 /* max:min, 10.6                     */
+} vga_top_motion_arg_t;
+
+#define VGA_TOP_MOTION_CTRL 0x01
+#define VGA_TOP_MOTION_POS 0x02
+#define VGA_TOP_MOTION_VEL 0x04
+#define VGA_TOP_MOTION_BOUND_X 0x08
+#define VGA_TOP_MOTION_BOUND_Y 0x10
+typedef struct
+{
+	__u32 frame_count; /* frames since reset                */
+	/* last completed frame */
+	__u16 missed_swaps;		 /* lines whose buffer swap was skipped */
+	__u16 dropped_sprites;	 /* sprites past the per-line limit     */
+	__u16 max_line_sprites;	 /* most sprites on any one line        */
+	__u16 max_tile_cycles;	 /* longest tile engine line, clocks    */
+	__u16 max_sprite_cycles; /* longest sprite engine line, clocks  */
+	/* totals since the previous VGA_TOP_READ_PERF */
+	__u16 overrun_missed;
+	__u16 overrun_dropped;
+} vga_top_perf_arg_t;
+
+#define VGA_TOP_LINES 480
+typedef struct
+{
+	__u16 x; /* map pixel at the screen's left edge */
+	__u16 y; /* map pixel at the screen's top edge  */
+} vga_top_scroll_arg_t;
+typedef struct
+{
+	__u8 width; /* map size in tiles, up to 128 x 64  */
+	__u8 height;
+	__u8 line_scroll; /* 1 = per-line scroll table        */
+} vga_top_map_arg_t;
+typedef struct
+{
+	__u16 first;				  /* first line to load                */
+	__u16 count;				  /* lines to load                     */
+	__u32 entries[VGA_TOP_LINES]; /* y:x, entries[0] is line first */
+} vga_top_line_scroll_arg_t;
+
+typedef struct
+{
+	__u8 enable; /* draw the foreground plane          */
+	__u8 width;	 /* map size in tiles, up to 128 x 64  */
+	__u8 height;
+	__u16 base; /* first tilemap entry of the map     */
+	__u16 key;	/* RGB555 colour drawn as transparent */
+} vga_top_fg_map_arg_t;
+
+#define VGA_TOP_TILEMAP_CHUNK 4096
+#define VGA_TOP_MAP_FG 4 /* tilemap arg map: the foreground plane */
+typedef struct
+{
+	__u8 map;							/* tilemap index, as in CTRL_REG, or VGA_TOP_MAP_FG */
+	__u16 cell;							/* first cell, row * width + col     */
+	__u16 count;						/* cells to write, up to a chunk     */
+	__u16 tiles[VGA_TOP_TILEMAP_CHUNK]; /* entries: [9] vflip, [8] hflip, [7:0] tile */
+} vga_top_tilemap_arg_t;
+
+#define VGA_TOP_PATTERN_CHUNK 16 /* frames per VGA_TOP_WRITE_PATTERN */
+typedef struct
+{
+	__u16 frame;									/* first 16x16 frame, 0-127          */
+	__u16 count;									/* frames to write, up to a chunk    */
+	__u16 pixels[VGA_TOP_PATTERN_CHUNK * 256]; /* RGB555, bit 15 = transparent, row-major */
+} vga_top_pattern_arg_t;
+
+#define VGA_TOP_PATTERN4_CHUNK 64 /* frames per VGA_TOP_WRITE_PATTERN4 */
+typedef struct
+{
+	__u16 frame;								/* first indexed frame, 0-255        */
+	__u16 count;								/* frames to write, up to a chunk    */
+	__u32 pixels[VGA_TOP_PATTERN4_CHUNK * 32]; /* 8 pixels per word, first in bits [3:0] */
+} vga_top_pattern4_arg_t;
+typedef struct
+{
+	__u8 palette;	  /* 0-15                              */
+	__u16 colors[16]; /* RGB555; colors[0] is unused, index 0 is transparent */
+} vga_top_palette_arg_t;
+typedef struct
+{
+	__u8 index;	  /* sprite, 0-127                     */
+	__u8 palette; /* 0-15                              */
+} vga_top_sprite_palette_arg_t;
+typedef struct
+{
+	__u8 index; /* table entry, 0-15                 */
+	__u8 enable;
+	__u8 base;	  /* tile replaced by the animation    */
+	__u8 frames;  /* base, base + 1, ... base + frames - 1 */
+	__u8 vblanks; /* vblanks per frame, 0 and 1 = every vblank */
+} vga_top_tile_anim_arg_t;
+typedef struct
+{
+	__u32 mask[8]; /* bit id % 32 of word id / 32: tile id is a hazard */
+} vga_top_hazard_tiles_arg_t;
+
+#define VGA_TOP_PAIR_ROWS 8
+/* Collision flags of the last complete frame, one bit per sprite slot
+ * (bit n % 32 of word n / 32) */
+typedef struct
+{
+	__u32 hit[4];						/* touched another sprite             */
+	__u32 hazard[4];					/* touched a hazard tile              */
+	__u32 pairs[VGA_TOP_PAIR_ROWS][4]; /* pairs[r]: sprites that sprite r touched */
+} vga_top_collision_arg_t;
+
+#define VGA_TOP_COLQ_MAP_CHUNK 4096
+typedef struct
+{
+	__u16 cell;	 /* first cell, row * width + col     */
+	__u16 count; /* cells to write, up to a chunk     */
+	__u8 classes[VGA_TOP_COLQ_MAP_CHUNK]; /* collision class, 0-15 */
+} vga_top_colq_map_arg_t;
+typedef struct
+{
+	__u8 width; /* query map size in tiles            */
+	__u8 height;
+	__u16 profile[16][16]; /* [class][column]: bit r = row r blocks */
+	__u8 hazard[16];	   /* 4 hazard bits per class            */
+} vga_top_colq_classes_arg_t;
+
+#define VGA_TOP_COLQ_BATCH 16
+/* Query: [31:26] h, [25:20] w, [19:10] y, [9:0] x, probing column x + w / 2
+ * Result: [30] blocked, [19:16] hazard, [10:0] first blocked row */
+typedef struct
+{
+	__u8 count; /* queries, up to a batch             */
+	__u32 query[VGA_TOP_COLQ_BATCH];
+	__u32 result[VGA_TOP_COLQ_BATCH];
+} vga_top_colq_arg_t;
+
+#define VGA_TOP_VTOTAL 525
+typedef struct
+{
+	__u8 enable; /* interrupt when vcount reaches line */
+	__u16 line;	 /* 0-524; 480 and up are in vblank   */
+} vga_top_line_irq_arg_t;
+
+#define VGA_TOP_EVENT_LINE 0x01
+#define VGA_TOP_EVENT_VBLANK 0x02
+typedef struct
+{
+	__u8 events;	   /* in: VGA_TOP_EVENT_* to wait for, out: the ones that fired */
+	__u32 frame_count; /* FRAME_COUNT when it fired; a gap of more than 1 is a missed frame */
+} vga_top_event_arg_t;
+
+/* Sprite attribute writes of the last complete frame that landed during
+ * active display, one bit per sprite slot (bit n % 32 of word n / 32).
+ * Unsafe ones hit while the beam was on the sprite's old or new lines. */
+typedef struct
+{
+	__u32 frame_count; /* FRAME_COUNT when read; the log is of the frame before */
+	__u32 unsafe[4];
+	__u32 active[4];
+	__u16 active_writes; /* saturating */
+	__u16 unsafe_writes;
+} vga_top_tear_arg_t;
 
 /* ---------------- ioctl magic ---------------- */
 #define VGA_TOP_MAGIC 'q'
@@ -25,5 +197,28 @@ typedef struct
 #define VGA_TOP_WRITE_CTRL _IOW(VGA_TOP_MAGIC, 0x01, vga_top_ctrl_arg_t)
 #define VGA_TOP_READ_STATUS _IOR(VGA_TOP_MAGIC, 0x02, vga_top_status_arg_t)
 #define VGA_TOP_WRITE_SPRITE _IOW(VGA_TOP_MAGIC, 0x03, vga_top_sprite_arg_t)
+#define VGA_TOP_READ_PERF _IOR(VGA_TOP_MAGIC, 0x04, vga_top_perf_arg_t)
+#define VGA_TOP_WRITE_ANIM _IOW(VGA_TOP_MAGIC, 0x05, vga_top_anim_arg_t)
+#define VGA_TOP_WRITE_MOTION _IOW(VGA_TOP_MAGIC, 0x06, vga_top_motion_arg_t)
+#define VGA_TOP_READ_MOTION _IOWR(VGA_TOP_MAGIC, 0x07, vga_top_motion_arg_t)
+#define VGA_TOP_WRITE_SCROLL _IOW(VGA_TOP_MAGIC, 0x08, vga_top_scroll_arg_t)
+#define VGA_TOP_WRITE_MAP _IOW(VGA_TOP_MAGIC, 0x09, vga_top_map_arg_t)
+#define VGA_TOP_WRITE_LINE_SCROLL _IOW(VGA_TOP_MAGIC, 0x0A, vga_top_line_scroll_arg_t)
+#define VGA_TOP_WRITE_TILEMAP _IOW(VGA_TOP_MAGIC, 0x0B, vga_top_tilemap_arg_t)
+#define VGA_TOP_WRITE_PATTERN _IOW(VGA_TOP_MAGIC, 0x0C, vga_top_pattern_arg_t)
+#define VGA_TOP_WRITE_PALETTE _IOW(VGA_TOP_MAGIC, 0x0D, vga_top_palette_arg_t)
+#define VGA_TOP_WRITE_SPRITE_PALETTE _IOW(VGA_TOP_MAGIC, 0x0E, vga_top_sprite_palette_arg_t)
+#define VGA_TOP_WRITE_PATTERN4 _IOW(VGA_TOP_MAGIC, 0x0F, vga_top_pattern4_arg_t)
+#define VGA_TOP_WRITE_FG_SCROLL _IOW(VGA_TOP_MAGIC, 0x10, vga_top_scroll_arg_t)
+#define VGA_TOP_WRITE_FG_MAP _IOW(VGA_TOP_MAGIC, 0x11, vga_top_fg_map_arg_t)
+#define VGA_TOP_WRITE_TILE_ANIM _IOW(VGA_TOP_MAGIC, 0x12, vga_top_tile_anim_arg_t)
+#define VGA_TOP_WRITE_HAZARD_TILES _IOW(VGA_TOP_MAGIC, 0x13, vga_top_hazard_tiles_arg_t)
+#define VGA_TOP_READ_COLLISION _IOR(VGA_TOP_MAGIC, 0x14, vga_top_collision_arg_t)
+#define VGA_TOP_WRITE_COLQ_MAP _IOW(VGA_TOP_MAGIC, 0x15, vga_top_colq_map_arg_t)
+#define VGA_TOP_WRITE_COLQ_CLASSES _IOW(VGA_TOP_MAGIC, 0x16, vga_top_colq_classes_arg_t)
+#define VGA_TOP_COLQ_QUERY _IOWR(VGA_TOP_MAGIC, 0x17, vga_top_colq_arg_t)
+#define VGA_TOP_WRITE_LINE_IRQ _IOW(VGA_TOP_MAGIC, 0x18, vga_top_line_irq_arg_t)
+#define VGA_TOP_WAIT_EVENT _IOWR(VGA_TOP_MAGIC, 0x19, vga_top_event_arg_t)
+#define VGA_TOP_READ_TEAR _IOR(VGA_TOP_MAGIC, 0x1A, vga_top_tear_arg_t)
 
 #endif /* _VGA_TOP_H */
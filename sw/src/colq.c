@@ -0,0 +1,155 @@
+#include "colq.h"
+#include "hw_interact.h"
+#include <math.h>
+
+static uint8_t colq_class[MAP_HEIGHT * MAP_WIDTH];
+static vga_top_colq_classes_arg_t colq_classes; // Profiles and hazard bits, as loaded
+static bool colq_hw = false;
+
+// Same rules as is_tile_blocked(), for pixel (x, y) of a tile
+static bool tile_blocks(int tile, int x, int y)
+{
+    switch (tile)
+    {
+    case TILE_WALL:
+        return true;
+    case TILE_FIRE:
+    case TILE_WATER:
+    case TILE_POISON:
+        return y >= 8;
+    case TILE_CEIL_L:
+        return y <= TILE_SIZE - 1 - x;
+    case TILE_CEIL_R:
+        return y <= x;
+    case TILE_SLOPE_L_UP:
+        return y >= x;
+    case TILE_SLOPE_R_UP:
+        return y >= TILE_SIZE - 1 - x;
+    default:
+        return false;
+    }
+}
+
+// Same rules as is_death()
+static uint8_t tile_hazard(int tile)
+{
+    switch (tile)
+    {
+    case TILE_FIRE:
+        return COLQ_HAZARD_WATERGIRL;
+    case TILE_WATER:
+        return COLQ_HAZARD_FIREBOY;
+    case TILE_POISON:
+        return COLQ_HAZARD_FIREBOY | COLQ_HAZARD_WATERGIRL;
+    default:
+        return 0;
+    }
+}
+
+void colq_load(void)
+{
+    colq_classes.width = MAP_WIDTH;
+    colq_classes.height = MAP_HEIGHT;
+    for (int c = 0; c < 16; c++)
+    {
+        for (int x = 0; x < TILE_SIZE; x++)
+        {
+            uint16_t rows = 0;
+            for (int y = 0; y < TILE_SIZE; y++)
+                if (tile_blocks(c, x, y))
+                    rows |= 1u << y;
+            colq_classes.profile[c][x] = rows;
+        }
+        colq_classes.hazard[c] = tile_hazard(c);
+    }
+    for (int ty = 0; ty < MAP_HEIGHT; ty++)
+        for (int tx = 0; tx < MAP_WIDTH; tx++)
+            colq_class[ty * MAP_WIDTH + tx] = (uint8_t)(tilemap[ty][tx] & 0xF);
+
+    // The bounds come with the classes and must be in place for the map
+    colq_hw = write_colq_classes(&colq_classes) == 0 &&
+              write_colq_map(0, MAP_HEIGHT * MAP_WIDTH, colq_class) == 0;
+}
+
+// Whole pixels; the probe rows start one below y + PLAYER_HITBOX_OFFSET_Y.
+// Off-map coordinates go to 1023, which answers blocked like any pixel
+// outside the map.
+static uint16_t to_pixel(float v)
+{
+    return (v < 0.0f || v > 1023.0f) ? 1023 : (uint16_t)floorf(v);
+}
+
+colq_box_t colq_player_box(float x, float y, float width, float height)
+{
+    int h = (int)height - PLAYER_HITBOX_OFFSET_Y;
+    colq_box_t box = {
+        .x = to_pixel(x + width / 2.0f),
+        .y = to_pixel(y + PLAYER_HITBOX_OFFSET_Y + 1),
+        .w = 0,
+        .h = (uint8_t)(h < 0 ? 0 : h > 63 ? 63 : h),
+    };
+    return box;
+}
+
+void colq_query_sw(const colq_box_t *boxes, colq_result_t *results, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        const colq_box_t *b = &boxes[i];
+        colq_result_t r = {false, 0, 0};
+        int cx = b->x + b->w / 2;
+
+        for (int y = b->y; y < b->y + b->h; y++)
+        {
+            int tx = cx / TILE_SIZE, ty = y / TILE_SIZE;
+            if (tx >= colq_classes.width || ty >= colq_classes.height)
+            {
+                if (!r.blocked)
+                    r.surface = (uint16_t)y;
+                r.blocked = true;
+                break;
+            }
+            uint8_t c = colq_class[ty * colq_classes.width + tx];
+            r.hazard |= colq_classes.hazard[c];
+            if (!r.blocked && (colq_classes.profile[c][cx % TILE_SIZE] >> (y % TILE_SIZE)) & 1)
+            {
+                r.blocked = true;
+                r.surface = (uint16_t)y;
+            }
+        }
+        results[i] = r;
+    }
+}
+
+static uint32_t pack_box(const colq_box_t *b)
+{
+    return ((uint32_t)(b->h & 0x3F) << 26) | ((uint32_t)(b->w & 0x3F) << 20) |
+           ((uint32_t)(b->y & 0x3FF) << 10) | (b->x & 0x3FF);
+}
+
+void colq_query(const colq_box_t *boxes, colq_result_t *results, int count)
+{
+    uint32_t query[COLQ_BATCH], result[COLQ_BATCH];
+
+    while (count > 0 && colq_hw)
+    {
+        int n = count > COLQ_BATCH ? COLQ_BATCH : count;
+        for (int i = 0; i < n; i++)
+            query[i] = pack_box(&boxes[i]);
+        if (colq_query_batch(query, result, (uint8_t)n))
+        {
+            colq_hw = false; // Answer the rest in software from now on
+            break;
+        }
+        for (int i = 0; i < n; i++)
+        {
+            results[i].blocked = (result[i] >> 30) & 1;
+            results[i].hazard = (result[i] >> 16) & 0xF;
+            results[i].surface = result[i] & 0x7FF;
+        }
+        boxes += n;
+        results += n;
+        count -= n;
+    }
+    colq_query_sw(boxes, results, count);
+}
@@ -1,23 +1,17 @@
 #include "vga_top.h"
+#include "hw_interact.h"
+#include <errno.h>
 #include <fcntl.h>
 #include <unistd.h>
 #include <stdio.h>
+#include <string.h>
 #include <stdint.h>
 #include <sys/ioctl.h>
+#include <time.h>
+#include "type.h"
 
 int vga_top_fd;
-
-inline uint32_t make_attr_word(uint8_t enable, uint8_t flip,
-                               uint16_t x, uint16_t y,
-                               uint8_t frame)
-{
-    return ((uint32_t)(enable & 1) << 31) |
-           ((uint32_t)(flip & 1) << 30) |
-           (0u << 27) |
-           ((uint32_t)(y & 0x1FF) << 18) |
-           ((uint32_t)(x & 0x3FF) << 8) |
-           (frame & 0xFF);
-}
+static uint32_t ctrl_word; // Last value written to CTRL_REG
 
 void write_ctrl(uint32_t value)
 {
@@ -27,6 +21,12 @@ void write_ctrl(uint32_t value)
         perror("ioctl(VGA_TOP_WRITE_CTRL) failed");
         return;
     }
+    ctrl_word = value;
+}
+
+void set_lowres(uint8_t on)
+{
+    write_ctrl(on ? ctrl_word | CTRL_LOWRES : ctrl_word & ~CTRL_LOWRES);
 }
 
 inline uint32_t make_ctrl_word(uint8_t tilemap_idx,
@@ -39,23 +39,20 @@ inline uint32_t make_ctrl_word(uint8_t tilemap_idx,
     return (audio << 29) | tmap;
 }
 
-/* High-level wrapper: set map and audio simultaneously */
+/* High-level wrapper: set map and audio simultaneously; lowres stays as set */
 void set_map_and_audio(uint8_t tilemap_idx,
                        uint8_t bgm_on,
                        uint8_t sfx_sel)
 {
     uint32_t ctrl = make_ctrl_word(tilemap_idx, bgm_on, sfx_sel);
-    write_ctrl(ctrl);
+    write_ctrl(ctrl | (ctrl_word & CTRL_LOWRES));
 }
 
-void write_sprite(uint8_t index,
-                  uint8_t enable, uint8_t flip,
-                  uint16_t x, uint16_t y,
-                  uint8_t frame)
+void write_sprite_attr(uint8_t index, uint32_t attr_word)
 {
     vga_top_sprite_arg_t arg = {
         .index = index,
-        .attr_word = make_attr_word(enable, flip, x, y, frame)};
+        .attr_word = attr_word};
     if (ioctl(vga_top_fd, VGA_TOP_WRITE_SPRITE, &arg))
     {
         perror("ioctl(VGA_TOP_WRITE_SPRITE) failed");
@@ -63,6 +60,26 @@ void write_sprite(uint8_t index,
     }
 }
 
+void write_sprite_anim(uint8_t index, uint32_t anim_word)
+{
+    vga_top_anim_arg_t arg = {
+        .index = index,
+        .anim_word = anim_word};
+    if (ioctl(vga_top_fd, VGA_TOP_WRITE_ANIM, &arg))
+    {
+        perror("ioctl(VGA_TOP_WRITE_ANIM) failed");
+        return;
+    }
+}
+
+void write_sprite(uint8_t index,
+                  uint8_t enable, uint8_t flip,
+                  uint16_t x, uint16_t y,
+                  uint8_t frame)
+{
+    write_sprite_attr(index, make_attr_word(enable, flip, SPRITE_16x16, x, y, frame));
+}
+
 void read_status(unsigned *col, unsigned *row)
 {
     vga_top_status_arg_t arg;
@@ -75,3 +92,436 @@ void read_status(unsigned *col, unsigned *row)
     *col = (arg.value >> 10) & 0x3FF;
     *row = arg.value & 0x3FF;
 }
+
+int write_motion(const vga_top_motion_arg_t *arg)
+{
+    if (ioctl(vga_top_fd, VGA_TOP_WRITE_MOTION, arg))
+    {
+        perror("ioctl(VGA_TOP_WRITE_MOTION) failed");
+        return -1;
+    }
+    return 0;
+}
+
+int read_motion(vga_top_motion_arg_t *arg)
+{
+    if (ioctl(vga_top_fd, VGA_TOP_READ_MOTION, arg))
+    {
+        perror("ioctl(VGA_TOP_READ_MOTION) failed");
+        return -1;
+    }
+    return 0;
+}
+
+void write_scroll(uint16_t x, uint16_t y)
+{
+    vga_top_scroll_arg_t arg = {.x = x, .y = y};
+    if (ioctl(vga_top_fd, VGA_TOP_WRITE_SCROLL, &arg))
+    {
+        perror("ioctl(VGA_TOP_WRITE_SCROLL) failed");
+        return;
+    }
+}
+
+int write_map_size(uint8_t width, uint8_t height, uint8_t line_scroll)
+{
+    vga_top_map_arg_t arg = {
+        .width = width,
+        .height = height,
+        .line_scroll = line_scroll};
+    if (ioctl(vga_top_fd, VGA_TOP_WRITE_MAP, &arg))
+    {
+        perror("ioctl(VGA_TOP_WRITE_MAP) failed");
+        return -1;
+    }
+    return 0;
+}
+
+void write_fg_scroll(uint16_t x, uint16_t y)
+{
+    vga_top_scroll_arg_t arg = {.x = x, .y = y};
+    if (ioctl(vga_top_fd, VGA_TOP_WRITE_FG_SCROLL, &arg))
+    {
+        perror("ioctl(VGA_TOP_WRITE_FG_SCROLL) failed");
+        return;
+    }
+}
+
+int write_fg_map(uint8_t enable, uint8_t width, uint8_t height, uint16_t base, uint16_t key)
+{
+    vga_top_fg_map_arg_t arg = {
+        .enable = enable,
+        .width = width,
+        .height = height,
+        .base = base,
+        .key = key};
+    if (ioctl(vga_top_fd, VGA_TOP_WRITE_FG_MAP, &arg))
+    {
+        perror("ioctl(VGA_TOP_WRITE_FG_MAP) failed");
+        return -1;
+    }
+    return 0;
+}
+
+int write_line_scroll(uint16_t first, uint16_t count, const uint32_t *entries)
+{
+    static vga_top_line_scroll_arg_t arg;
+
+    if (first >= VGA_TOP_LINES || count > VGA_TOP_LINES - first)
+        return -1;
+    arg.first = first;
+    arg.count = count;
+    memcpy(arg.entries, entries, count * sizeof(uint32_t));
+    if (ioctl(vga_top_fd, VGA_TOP_WRITE_LINE_SCROLL, &arg))
+    {
+        perror("ioctl(VGA_TOP_WRITE_LINE_SCROLL) failed");
+        return -1;
+    }
+    return 0;
+}
+
+int write_tilemap(uint8_t map, uint16_t cell, uint16_t count, const uint16_t *tiles)
+{
+    static vga_top_tilemap_arg_t arg;
+
+    while (count > 0)
+    {
+        uint16_t n = count > VGA_TOP_TILEMAP_CHUNK ? VGA_TOP_TILEMAP_CHUNK : count;
+        arg.map = map;
+        arg.cell = cell;
+        arg.count = n;
+        memcpy(arg.tiles, tiles, n * sizeof(arg.tiles[0]));
+        if (ioctl(vga_top_fd, VGA_TOP_WRITE_TILEMAP, &arg))
+        {
+            perror("ioctl(VGA_TOP_WRITE_TILEMAP) failed");
+            return -1;
+        }
+        cell += n;
+        tiles += n;
+        count -= n;
+    }
+    return 0;
+}
+
+int write_tile_anim(uint8_t index, uint8_t enable, uint8_t base, uint8_t frames, uint8_t vblanks)
+{
+    vga_top_tile_anim_arg_t arg = {
+        .index = index,
+        .enable = enable,
+        .base = base,
+        .frames = frames,
+        .vblanks = vblanks};
+    if (ioctl(vga_top_fd, VGA_TOP_WRITE_TILE_ANIM, &arg))
+    {
+        perror("ioctl(VGA_TOP_WRITE_TILE_ANIM) failed");
+        return -1;
+    }
+    return 0;
+}
+
+int write_sprite_frames(uint8_t frame, uint16_t count, const uint16_t *pixels)
+{
+    static vga_top_pattern_arg_t arg;
+
+    if (frame + count > 128)
+        return -1;
+    while (count > 0)
+    {
+        uint16_t n = count > VGA_TOP_PATTERN_CHUNK ? VGA_TOP_PATTERN_CHUNK : count;
+        arg.frame = frame;
+        arg.count = n;
+        memcpy(arg.pixels, pixels, n * 256 * sizeof(uint16_t));
+        if (ioctl(vga_top_fd, VGA_TOP_WRITE_PATTERN, &arg))
+        {
+            perror("ioctl(VGA_TOP_WRITE_PATTERN) failed");
+            return -1;
+        }
+        frame += n;
+        pixels += n * 256;
+        count -= n;
+    }
+    return 0;
+}
+
+int load_sprite_bank(const char *path, uint8_t frame)
+{
+    static uint16_t pixels[256 * 256];
+    FILE *f = fopen(path, "rb");
+    size_t n;
+
+    if (!f)
+    {
+        perror(path);
+        return -1;
+    }
+    n = fread(pixels, 256 * sizeof(uint16_t), 256 - frame, f);
+    fclose(f);
+    if (n == 0 || write_sprite_frames(frame, n, pixels))
+        return -1;
+    return (int)n;
+}
+
+int write_sprite_frames4(uint8_t frame, uint16_t count, const uint8_t *packed)
+{
+    static vga_top_pattern4_arg_t arg;
+
+    if (frame + count > 256)
+        return -1;
+    while (count > 0)
+    {
+        uint16_t n = count > VGA_TOP_PATTERN4_CHUNK ? VGA_TOP_PATTERN4_CHUNK : count;
+        arg.frame = frame;
+        arg.count = n;
+        memcpy(arg.pixels, packed, n * 128);
+        if (ioctl(vga_top_fd, VGA_TOP_WRITE_PATTERN4, &arg))
+        {
+            perror("ioctl(VGA_TOP_WRITE_PATTERN4) failed");
+            return -1;
+        }
+        frame += n;
+        packed += n * 128;
+        count -= n;
+    }
+    return 0;
+}
+
+int load_sprite_bank4(const char *path, uint8_t frame, uint8_t palette)
+{
+    static uint8_t packed[256 * 128];
+    uint16_t colors[16];
+    FILE *f = fopen(path, "rb");
+    size_t n;
+
+    if (!f)
+    {
+        perror(path);
+        return -1;
+    }
+    if (fread(colors, sizeof(colors), 1, f) != 1)
+    {
+        fclose(f);
+        return -1;
+    }
+    n = fread(packed, 128, 256 - frame, f);
+    fclose(f);
+    if (n == 0 || write_sprite_frames4(frame, n, packed))
+        return -1;
+    write_palette(palette, colors);
+    return (int)n;
+}
+
+void write_palette(uint8_t palette, const uint16_t colors[16])
+{
+    vga_top_palette_arg_t arg = {.palette = palette};
+    memcpy(arg.colors, colors, sizeof(arg.colors));
+    if (ioctl(vga_top_fd, VGA_TOP_WRITE_PALETTE, &arg))
+    {
+        perror("ioctl(VGA_TOP_WRITE_PALETTE) failed");
+        return;
+    }
+}
+
+void write_sprite_palette(uint8_t index, uint8_t palette)
+{
+    vga_top_sprite_palette_arg_t arg = {
+        .index = index,
+        .palette = palette};
+    if (ioctl(vga_top_fd, VGA_TOP_WRITE_SPRITE_PALETTE, &arg))
+    {
+        perror("ioctl(VGA_TOP_WRITE_SPRITE_PALETTE) failed");
+        return;
+    }
+}
+
+int write_hazard_tiles(const uint32_t mask[8])
+{
+    vga_top_hazard_tiles_arg_t arg;
+    memcpy(arg.mask, mask, sizeof(arg.mask));
+    if (ioctl(vga_top_fd, VGA_TOP_WRITE_HAZARD_TILES, &arg))
+    {
+        perror("ioctl(VGA_TOP_WRITE_HAZARD_TILES) failed");
+        return -1;
+    }
+    return 0;
+}
+
+int read_collision(vga_top_collision_arg_t *coll)
+{
+    if (ioctl(vga_top_fd, VGA_TOP_READ_COLLISION, coll))
+    {
+        perror("ioctl(VGA_TOP_READ_COLLISION) failed");
+        return -1;
+    }
+    return 0;
+}
+
+int write_colq_map(uint16_t cell, uint16_t count, const uint8_t *classes)
+{
+    static vga_top_colq_map_arg_t arg;
+
+    while (count > 0)
+    {
+        uint16_t n = count > VGA_TOP_COLQ_MAP_CHUNK ? VGA_TOP_COLQ_MAP_CHUNK : count;
+        arg.cell = cell;
+        arg.count = n;
+        memcpy(arg.classes, classes, n);
+        if (ioctl(vga_top_fd, VGA_TOP_WRITE_COLQ_MAP, &arg))
+        {
+            perror("ioctl(VGA_TOP_WRITE_COLQ_MAP) failed");
+            return -1;
+        }
+        cell += n;
+        classes += n;
+        count -= n;
+    }
+    return 0;
+}
+
+int write_colq_classes(const vga_top_colq_classes_arg_t *classes)
+{
+    if (ioctl(vga_top_fd, VGA_TOP_WRITE_COLQ_CLASSES, classes))
+    {
+        perror("ioctl(VGA_TOP_WRITE_COLQ_CLASSES) failed");
+        return -1;
+    }
+    return 0;
+}
+
+int colq_query_batch(const uint32_t *query, uint32_t *result, uint8_t count)
+{
+    vga_top_colq_arg_t arg;
+
+    if (count > VGA_TOP_COLQ_BATCH)
+        return -1;
+    arg.count = count;
+    memcpy(arg.query, query, count * sizeof(arg.query[0]));
+    if (ioctl(vga_top_fd, VGA_TOP_COLQ_QUERY, &arg))
+    {
+        perror("ioctl(VGA_TOP_COLQ_QUERY) failed");
+        return -1;
+    }
+    memcpy(result, arg.result, count * sizeof(arg.result[0]));
+    return 0;
+}
+
+int read_tear(vga_top_tear_arg_t *tear)
+{
+    if (ioctl(vga_top_fd, VGA_TOP_READ_TEAR, tear))
+    {
+        perror("ioctl(VGA_TOP_READ_TEAR) failed");
+        return -1;
+    }
+    return 0;
+}
+
+int read_perf(vga_top_perf_arg_t *perf)
+{
+    if (ioctl(vga_top_fd, VGA_TOP_READ_PERF, perf))
+    {
+        perror("ioctl(VGA_TOP_READ_PERF) failed");
+        return -1;
+    }
+    return 0;
+}
+
+int write_line_irq(uint8_t enable, uint16_t line)
+{
+    vga_top_line_irq_arg_t arg = {.enable = enable, .line = line};
+    if (ioctl(vga_top_fd, VGA_TOP_WRITE_LINE_IRQ, &arg))
+    {
+        perror("ioctl(VGA_TOP_WRITE_LINE_IRQ) failed");
+        return -1;
+    }
+    return 0;
+}
+
+int wait_raster_event(uint8_t events, uint32_t *frame_count)
+{
+    vga_top_event_arg_t arg = {.events = events};
+    if (ioctl(vga_top_fd, VGA_TOP_WAIT_EVENT, &arg))
+        return -1;
+    *frame_count = arg.frame_count;
+    return arg.events;
+}
+
+/* Sleep for roughly `lines` scanlines, keeping a small margin so the
+ * following status read lands just before the target line */
+static void sleep_lines(unsigned lines)
+{
+    if (lines > 2)
+    {
+        struct timespec ts = {0, (long)(lines - 2) * LINE_TIME_NS};
+        nanosleep(&ts, NULL);
+    }
+}
+
+static int vblank_irq = 1; // Cleared when the driver has no raster interrupt
+static uint32_t last_frame;
+static unsigned missed_frames;
+static struct timespec vblank_seen; // When the polled path last saw line VACTIVE
+static int vblank_synced;
+
+unsigned frames_missed(void)
+{
+    unsigned n = missed_frames;
+    missed_frames = 0;
+    return n;
+}
+
+static long ns_since(const struct timespec *t)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - t->tv_sec) * 1000000000L + (now.tv_nsec - t->tv_nsec);
+}
+
+/* Block until the start of the next vertical blanking interval.
+ * Sleeps on the vblank interrupt. Without it, the beam is predicted from
+ * the last vblank seen, the whole rest of the frame is slept in one go and
+ * a single status read confirms the landing, so a frame costs one ioctl;
+ * only a wake-up before line VACTIVE costs more. */
+void wait_for_vblank(void)
+{
+    unsigned col = 0, row = 0, lines;
+    uint32_t frame;
+
+    if (vblank_irq)
+    {
+        if (wait_raster_event(VGA_TOP_EVENT_VBLANK, &frame) >= 0)
+        {
+            if (last_frame != 0 && frame - last_frame > 1)
+                missed_frames += frame - last_frame - 1;
+            last_frame = frame;
+            return;
+        }
+        if (errno == ENODEV)
+            vblank_irq = 0;
+    }
+
+    if (vblank_synced)
+        row = (VACTIVE + ns_since(&vblank_seen) / LINE_TIME_NS) % VTOTAL;
+    else
+        read_status(&col, &row);
+
+    // Aim one line into blanking, past the next line VACTIVE
+    lines = (row < VACTIVE ? VACTIVE - row : VTOTAL - row + VACTIVE) + 1;
+    struct timespec ts = {0, (long)lines * LINE_TIME_NS};
+    nanosleep(&ts, NULL);
+    read_status(&col, &row);
+
+    // Woke outside blanking: the prediction was off, so poll the rest of the way
+    while (row < VACTIVE)
+    {
+        sleep_lines(VACTIVE - row);
+        read_status(&col, &row);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &vblank_seen);
+    vblank_seen.tv_nsec -= (long)(row - VACTIVE) * LINE_TIME_NS;
+    if (vblank_seen.tv_nsec < 0)
+    {
+        vblank_seen.tv_sec--;
+        vblank_seen.tv_nsec += 1000000000L;
+    }
+    vblank_synced = 1;
+}
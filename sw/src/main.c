@@ -1,10 +1,14 @@
 #include <stdio.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include "colq.h"
 #include "hw_interact.h"
 #include "player.h"
 #include "joypad_input.h"
+#include "motion.h"
+#include "particle.h"
 #include "sprite.h" 
+#include "trigger.h"
 #include "type.h"
 #include <time.h>
 
@@ -16,42 +20,73 @@ elevator_t elevators[NUM_ELEVATORS];
 button_t buttons[NUM_BUTTONS];
 unsigned frame_counter = 0;
 
-int main()
+// Level wiring: lever 0 drives elevator 0, button 0 OR button 1 drives elevator 1
+static const trigger_link_t level_triggers[] = {
+    {SENSOR_LEVER, 0, ACTUATOR_ELEVATOR, 0},
+    {SENSOR_BUTTON, 0, ACTUATOR_ELEVATOR, 1},
+    {SENSOR_BUTTON, 1, ACTUATOR_ELEVATOR, 1},
+};
+
+static game_state_t game_state = GAME_ATTRACT;
+static unsigned state_frames = 0; // Frames spent in the current state
+
+#define PERF_REPORT_FRAMES 60 // Poll the display counters once a second
+#define TEAR_REPORT 0         // 1: list the sprites written while on screen, every frame
+
+static double now_ms(void)
 {
-    if ((vga_top_fd = open("/dev/vga_top", O_RDWR)) == -1)
-    {
-        fprintf(stderr, "Error: cannot open /dev/vga_top\n");
-        return -1;
-    }
-Logo:
-    input_handler_init();
-    for (int i = 0; i < 32; i++)
-    {
-        write_sprite(i, 0, 0, 0, 0, 0); // disable=0, position 0, frame 0
-    }
-    while (1)
-    {
-        set_map_and_audio(0, 0, 0); // Start VGA controller
-        for (int i = 0; i < NUM_PLAYERS; i++)
-        {
-            game_action_t action = get_player_action(i);
-            if (action != ACTION_NONE)
-            {
-                goto Game;
-            }
-        }
-    }
-    // debug_draw_test_sprites();
-Game:
-    set_map_and_audio(1, 1, 0);
-    input_handler_init();
-    player_init(&players[0], 64, 360, 0, 1, PLAYER_FIREBOY);
-    player_init(&players[1], 64, 420, 2, 3, PLAYER_WATERGIRL);
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+// Report display overruns next to the worst logic time since the last poll
+static void perf_report(double tick_ms_max)
+{
+    vga_top_perf_arg_t perf;
+
+    unsigned missed_frames = frames_missed();
+
+    if (read_perf(&perf))
+        return;
+    if (perf.overrun_missed || perf.overrun_dropped || missed_frames)
+        fprintf(stderr, "[PERF] frame %u: %u missed swaps, %u dropped sprites, %u missed frames "
+                        "(last frame: %u max/line, tile %u / sprite %u clocks), tick max %.2f ms\n",
+                perf.frame_count, perf.overrun_missed, perf.overrun_dropped, missed_frames,
+                perf.max_line_sprites, perf.max_tile_cycles, perf.max_sprite_cycles,
+                tick_ms_max);
+}
+
+// Sprite slots whose attribute write landed on the lines being drawn in the
+// frame that just ended
+static void tear_report(void)
+{
+    vga_top_tear_arg_t tear;
 
-    // player_init(&players[0], 368, 224, 0, 1, PLAYER_FIREBOY);
-    // player_init(&players[1], 320, 152, 2, 3, PLAYER_WATERGIRL);
+    if (read_tear(&tear) || tear.unsafe_writes == 0)
+        return;
+    fprintf(stderr, "[TEAR] frame %u: %u of %u writes during scanout unsafe, sprites",
+            tear.frame_count - 1, tear.unsafe_writes, tear.active_writes);
+    for (uint8_t slot = 0; slot < NUM_HW_SPRITES; slot++)
+        if (collision_bit(tear.unsafe, slot))
+            fprintf(stderr, " %u", slot);
+    fprintf(stderr, "\n");
+}
+
+// Place players, gems and mechanisms for the level
+static void level_load(void)
+{
+    sprite_pool_reset();
+    motion_reset();
+    colq_load();
+
+    player_init(&players[0], 64, 360, PLAYER_FIREBOY);
+    player_init(&players[1], 64, 420, PLAYER_WATERGIRL);
 
-    item_init(&items[0], 0, 0, 4, BLUE_GEM_FRAME);
+    // player_init(&players[0], 368, 224, PLAYER_FIREBOY);
+    // player_init(&players[1], 320, 152, PLAYER_WATERGIRL);
+
+    item_init(&items[0], 0, 0, BLUE_GEM_FRAME);
     item_place_on_tile(&items[0], 21, 26);
     items[0].sprite.frame_count = 1;
     items[0].sprite.frame_start = BLUE_GEM_FRAME;
@@ -60,7 +95,7 @@ Game:
     items[0].width = 12;  // Collision box width
     items[0].height = 12; // Collision box height
 
-    item_init(&items[1], 0, 0, 5, RED_GEM_FRAME);
+    item_init(&items[1], 0, 0, RED_GEM_FRAME);
     item_place_on_tile(&items[1], 29, 26);
     items[1].sprite.frame_count = 1;
     items[1].sprite.frame_start = RED_GEM_FRAME;
@@ -69,7 +104,7 @@ Game:
     items[1].width = 12;  // Collision box width
     items[1].height = 12; // Collision box height
 
-    item_init(&items[2], 0, 0, 6, RED_GEM_FRAME);
+    item_init(&items[2], 0, 0, RED_GEM_FRAME);
     item_place_on_tile(&items[2], 6, 14);
     items[2].sprite.frame_count = 1;
     items[2].sprite.frame_start = RED_GEM_FRAME;
@@ -78,7 +113,7 @@ Game:
     items[2].width = 12;  // Collision box width
     items[2].height = 12; // Collision box height
 
-    item_init(&items[3], 0, 0, 7, BLUE_GEM_FRAME);
+    item_init(&items[3], 0, 0, BLUE_GEM_FRAME);
     item_place_on_tile(&items[3], 23, 14);
     items[3].sprite.frame_count = 1;
     items[3].sprite.frame_start = BLUE_GEM_FRAME;
@@ -87,7 +122,7 @@ Game:
     items[3].width = 12;  // Collision box width
     items[3].height = 12; // Collision box height
 
-    item_init(&items[4], 0, 0, 8, BLUE_GEM_FRAME);
+    item_init(&items[4], 0, 0, BLUE_GEM_FRAME);
     item_place_on_tile(&items[4], 11, 7);
     items[4].sprite.frame_count = 1;
     items[4].sprite.frame_start = BLUE_GEM_FRAME;
@@ -96,7 +131,7 @@ Game:
     items[4].width = 12;  // Collision box width
     items[4].height = 12; // Collision box height
 
-    item_init(&items[5], 0, 0, 9, RED_GEM_FRAME);
+    item_init(&items[5], 0, 0, RED_GEM_FRAME);
     item_place_on_tile(&items[5], 1, 4);
     items[5].sprite.frame_count = 1;
     items[5].sprite.frame_start = RED_GEM_FRAME;
@@ -105,100 +140,165 @@ Game:
     items[5].width = 12;  // Collision box width
     items[5].height = 12; // Collision box height
 
-    box_init(&boxes[0], 17, 10, 10, BOX_FRAME);
+    box_init(&boxes[0], 17, 10, BOX_FRAME);
 
-    lever_init(&levers[0], 9, 21, 22);
+    lever_init(&levers[0], 9, 21);
 
-    elevator_init(&elevators[0], 1, 16, 16, 19, 14, 51);
-    elevator_init(&elevators[1], 35, 12, 12, 16, 18, 57);
+    elevator_init(&elevators[0], 1, 16, 16, 19, LIFT_YELLOW_FRAME);
+    elevator_init(&elevators[1], 35, 12, 12, 16, LIFT_PURPLE_FRAME);
 
-    button_init(&buttons[0], 32, 12, 26);
-    button_init(&buttons[1], 32, 17, 29);
+    button_init(&buttons[0], 32, 12);
+    button_init(&buttons[1], 32, 17);
 
-    unsigned col = 0, row = 0;
-    while (1)
+    trigger_load(level_triggers, sizeof(level_triggers) / sizeof(level_triggers[0]));
+    particle_init();
+}
+
+// Switch state and run its one-off entry actions
+static void game_enter(game_state_t next)
+{
+    game_state = next;
+    state_frames = 0;
+
+    switch (next)
     {
+    case GAME_ATTRACT:
+        // Reopen the joypads so buttons held during play don't skip the logo
+        input_handler_cleanup();
+        input_handler_init();
+        sprite_pool_reset(); // The next sprite_commit() disables every slot
+        particle_init();
+        set_map_and_audio(0, 0, 0);
+        break;
+    case GAME_LEVEL_INTRO:
+        set_map_and_audio(1, 1, 0);
+        level_load();
+        break;
+    case GAME_DEATH:
+        set_map_and_audio(1, 1, 0);
+        set_map_and_audio(1, 1, 2);
+        break;
+    case GAME_PLAY:
+    case GAME_LEVEL_COMPLETE:
+        break;
+    }
+}
 
-        frame_counter++;
-        // === Frame synchronization: execute only once at the top of each frame (row==0) ===
-        do
+static void attract_tick(void)
+{
+    for (int i = 0; i < NUM_PLAYERS; i++)
+    {
+        if (get_player_action(i) != ACTION_NONE)
         {
-            read_status(&col, &row);
-        } while (row != 0);
+            game_enter(GAME_LEVEL_INTRO);
+            return;
+        }
+    }
+}
 
-        // === 1. Logic update phase ===
-        for (int i = 0; i < NUM_PLAYERS; i++)
+static void play_tick(void)
+{
+    for (int i = 0; i < NUM_PLAYERS; i++)
+    {
+        player_handle_input(&players[i], i);
+        int situation = player_update_physics(&players[i]);
+        if (situation == 2)
         {
-            player_handle_input(&players[i], i);
-            int situation = player_update_physics(&players[i]);
-            if (situation == 1)
-            {
-                set_map_and_audio(1, 1, 0);
-                set_map_and_audio(1, 1, 2);
-                sleep(1);
-                goto Logo;
-            }
-            else if (situation == 2)
-            {
-                goto Logo;
-            }
+            game_enter(GAME_LEVEL_COMPLETE);
+            return;
+        }
 
-            for (int j = 0; j < NUM_ITEMS; j++)
-            {
-                if (!items[j].active)
-                    continue;
-
-                // Determine if the character is allowed to collect
-                if ((items[j].owner_type == ITEM_FIREBOY_ONLY && players[i].type != PLAYER_FIREBOY) ||
-                    (items[j].owner_type == ITEM_WATERGIRL_ONLY && players[i].type != PLAYER_WATERGIRL))
-                {
-                    continue;
-                }
-
-                float pw = SPRITE_W_PIXELS;      // Width stays at 16
-                float ph = PLAYER_HITBOX_HEIGHT; // Actual height that participates in collision
-                float px = players[i].x;
-                float py = players[i].y + PLAYER_HITBOX_OFFSET_Y; // Skip transparent pixel area at the top
-
-                if (check_overlap(px, py, pw, ph,
-                                  items[j].x, items[j].y, items[j].width, items[j].height))
-                {
-                    items[j].active = false;
-                }
-            }
-            for (int i = 0; i < NUM_BOXES; i++)
-            {
-                for (int j = 0; j < NUM_PLAYERS; j++)
-                {
-                    box_try_push(&boxes[i], &players[j]);
-                }
-                box_update_position(&boxes[i], players);
-            }
-            for (int i = 0; i < NUM_LEVERS; i++)
+        for (int j = 0; j < NUM_ITEMS; j++)
+        {
+            if (!items[j].active)
+                continue;
+
+            // Determine if the character is allowed to collect
+            if ((items[j].owner_type == ITEM_FIREBOY_ONLY && players[i].type != PLAYER_FIREBOY) ||
+                (items[j].owner_type == ITEM_WATERGIRL_ONLY && players[i].type != PLAYER_WATERGIRL))
             {
-                lever_update(&levers[0], players);
+                continue;
             }
-            for (int i = 0; i < NUM_ELEVATORS; i++)
+
+            float pw = SPRITE_W_PIXELS;      // Width stays at 16
+            float ph = PLAYER_HITBOX_HEIGHT; // Actual height that participates in collision
+            float px = players[i].x;
+            float py = players[i].y + PLAYER_HITBOX_OFFSET_Y; // Skip transparent pixel area at the top
+
+            if (check_overlap(px, py, pw, ph,
+                              items[j].x, items[j].y, items[j].width, items[j].height))
             {
-                if (i == 0)
-                    elevator_update(&elevators[i], levers[0].activated, players);
-                if (i == 1)
-                {
-                    elevator_update(&elevators[i], buttons[0].pressed || buttons[1].pressed, players);
-                }
+                items[j].active = false;
+                particle_burst(items[j].x + 6, items[j].y + 6, 8, PARTICLE_SPARKLE_FRAME, PARTICLE_PRIO_BURST);
             }
-            for (int i = 0; i < NUM_BUTTONS; i++)
+        }
+        for (int i = 0; i < NUM_BOXES; i++)
+        {
+            for (int j = 0; j < NUM_PLAYERS; j++)
             {
-                button_update(&buttons[i], players);
+                box_try_push(&boxes[i], &players[j]);
             }
+            box_update_position(&boxes[i], players);
         }
-        // === 2. Wait for blanking area ===
-        do
+        trigger_update(players);
+    }
+
+    // The hazard probes of both players go to the query unit as one batch,
+    // at the positions they moved to
+    colq_box_t probe[NUM_PLAYERS];
+    colq_result_t hit[NUM_PLAYERS];
+    for (int i = 0; i < NUM_PLAYERS; i++)
+        probe[i] = colq_player_box(players[i].x, players[i].y + 1, SPRITE_W_PIXELS, PLAYER_HEIGHT_PIXELS);
+    colq_query(probe, hit, NUM_PLAYERS);
+    for (int i = 0; i < NUM_PLAYERS; i++)
+    {
+        uint8_t deadly = players[i].type == PLAYER_FIREBOY ? COLQ_HAZARD_FIREBOY : COLQ_HAZARD_WATERGIRL;
+        if (hit[i].hazard & deadly)
         {
-            read_status(&col, &row);
-        } while (row < VACTIVE);
+            game_enter(GAME_DEATH);
+            return;
+        }
+    }
+    particle_spawn_hazards();
+}
 
-        // === 3. Write sprites to VGA ===
+// Advance the current state by one frame; every state does bounded work
+static void game_tick(void)
+{
+    state_frames++;
+
+    switch (game_state)
+    {
+    case GAME_ATTRACT:
+        attract_tick();
+        break;
+    case GAME_LEVEL_INTRO:
+        if (state_frames >= LEVEL_INTRO_FRAMES)
+            game_enter(GAME_PLAY);
+        break;
+    case GAME_PLAY:
+        play_tick();
+        break;
+    case GAME_DEATH:
+        if (state_frames >= DEATH_FRAMES)
+            game_enter(GAME_ATTRACT);
+        break;
+    case GAME_LEVEL_COMPLETE:
+        if (state_frames >= LEVEL_COMPLETE_FRAMES)
+            game_enter(GAME_ATTRACT);
+        break;
+    }
+
+    // Effects keep moving through the intro/death/complete pauses
+    if (game_state != GAME_ATTRACT)
+        particle_update();
+}
+
+// Write sprites to VGA, only called during the blanking area
+static void game_render(void)
+{
+    if (game_state != GAME_ATTRACT)
+    {
         for (int i = 0; i < NUM_PLAYERS; i++)
         {
             player_update_sprite(&players[i]);
@@ -211,6 +311,45 @@ Game:
         {
             box_update_sprite(&boxes[i]);
         }
+    }
+    sprite_commit();
+}
+
+int main()
+{
+    if ((vga_top_fd = open("/dev/vga_top", O_RDWR)) == -1)
+    {
+        fprintf(stderr, "Error: cannot open /dev/vga_top\n");
+        return -1;
+    }
+    game_enter(GAME_ATTRACT);
+
+    double tick_ms_max = 0;
+
+    while (1)
+    {
+        frame_counter++;
+
+        // === 1. Logic update phase ===
+        double t0 = now_ms();
+        game_tick();
+        double tick_ms = now_ms() - t0;
+        if (tick_ms > tick_ms_max)
+            tick_ms_max = tick_ms;
+
+        if (frame_counter % PERF_REPORT_FRAMES == 0)
+        {
+            perf_report(tick_ms_max);
+            tick_ms_max = 0;
+        }
+
+        // === 2. Wait for blanking area ===
+        wait_for_vblank();
+        if (TEAR_REPORT)
+            tear_report();
+
+        // === 3. Write sprites to VGA ===
+        game_render();
         // clock_t end = clock();
         // float duration = (float)(end - start) / CLOCKS_PER_SEC * 1000;
         // printf("[FRAME] duration = %.2f ms\n", duration);
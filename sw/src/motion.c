@@ -0,0 +1,103 @@
+#include "motion.h"
+#include "hw_interact.h"
+
+#define MOTION_ONE (1 << MOTION_FRAC_BITS)
+
+static uint8_t motion_count = 0;
+
+// Software view of each channel, to skip redundant writes and to place
+// linked sprites for culling without reading the hardware
+static int16_t motion_vx[NUM_MOTION_CHANNELS], motion_vy[NUM_MOTION_CHANNELS];
+static int motion_x[NUM_MOTION_CHANNELS], motion_y[NUM_MOTION_CHANNELS];
+
+static uint16_t to_fixed(float v)
+{
+    return (uint16_t)(v * MOTION_ONE + 0.5f);
+}
+
+static uint32_t pack(uint16_t hi, uint16_t lo)
+{
+    return ((uint32_t)hi << 16) | lo;
+}
+
+void motion_reset(void)
+{
+    vga_top_motion_arg_t arg = {.write_mask = VGA_TOP_MOTION_CTRL, .ctrl = 0};
+
+    for (uint8_t ch = 0; ch < motion_count; ch++)
+    {
+        arg.channel = ch;
+        write_motion(&arg);
+    }
+    motion_count = 0;
+}
+
+int8_t motion_alloc(void)
+{
+    if (motion_count >= NUM_MOTION_CHANNELS)
+        return -1;
+    motion_vx[motion_count] = motion_vy[motion_count] = 0;
+    motion_x[motion_count] = motion_y[motion_count] = 0;
+    return (int8_t)motion_count++;
+}
+
+void motion_setup(int8_t ch, float x, float y,
+                  motion_mode_t mode_x, float min_x, float max_x,
+                  motion_mode_t mode_y, float min_y, float max_y)
+{
+    vga_top_motion_arg_t arg = {
+        .channel = (uint8_t)ch,
+        .write_mask = VGA_TOP_MOTION_CTRL | VGA_TOP_MOTION_POS | VGA_TOP_MOTION_VEL |
+                      VGA_TOP_MOTION_BOUND_X | VGA_TOP_MOTION_BOUND_Y,
+        .ctrl = (1u << 31) | ((uint32_t)mode_y << 2) | mode_x,
+        .pos = pack(to_fixed(y), to_fixed(x)),
+        .vel = 0,
+        .bound_x = pack(to_fixed(max_x), to_fixed(min_x)),
+        .bound_y = pack(to_fixed(max_y), to_fixed(min_y)),
+    };
+
+    if (ch < 0)
+        return;
+    write_motion(&arg);
+    motion_vx[ch] = motion_vy[ch] = 0;
+    motion_x[ch] = (int)x;
+    motion_y[ch] = (int)y;
+}
+
+void motion_set_velocity(int8_t ch, float vx, float vy)
+{
+    int16_t fx = (int16_t)(vx * MOTION_ONE);
+    int16_t fy = (int16_t)(vy * MOTION_ONE);
+    vga_top_motion_arg_t arg = {
+        .channel = (uint8_t)ch,
+        .write_mask = VGA_TOP_MOTION_VEL,
+        .vel = pack((uint16_t)fy, (uint16_t)fx),
+    };
+
+    if (ch < 0 || (fx == motion_vx[ch] && fy == motion_vy[ch]))
+        return;
+    write_motion(&arg);
+    motion_vx[ch] = fx;
+    motion_vy[ch] = fy;
+}
+
+void motion_read(int8_t ch, float *x, float *y)
+{
+    vga_top_motion_arg_t arg = {.channel = (uint8_t)ch};
+
+    if (ch < 0 || read_motion(&arg))
+        return;
+    *x = (float)(arg.pos & 0xFFFF) / MOTION_ONE;
+    *y = (float)(arg.pos >> 16) / MOTION_ONE;
+    motion_x[ch] = (int)*x;
+    motion_y[ch] = (int)*y;
+    // Stop and bounce change the velocity in hardware
+    motion_vx[ch] = (int16_t)(arg.vel & 0xFFFF);
+    motion_vy[ch] = (int16_t)(arg.vel >> 16);
+}
+
+void motion_origin(int8_t ch, int *x, int *y)
+{
+    *x = motion_x[ch];
+    *y = motion_y[ch];
+}
@@ -0,0 +1,218 @@
+// particle.c
+// Sparks, splashes and pickup bursts. State is kept as structure-of-arrays
+// so the integration loop vectorizes (NEON on the board).
+#include "particle.h"
+#include "hw_interact.h"
+#include "sprite.h"
+#include "type.h"
+#include <stdbool.h>
+
+#define CELL_EMPTY 0
+#define CELL_SOLID 1
+#define CELL_LIQUID 2
+
+#define MAX_HAZARDS 64
+#define HAZARD_SPAWN_PERIOD 8 // Frames between ambient particles
+
+static float p_x[MAX_PARTICLES] __attribute__((aligned(16)));
+static float p_y[MAX_PARTICLES] __attribute__((aligned(16)));
+static float p_vx[MAX_PARTICLES] __attribute__((aligned(16)));
+static float p_vy[MAX_PARTICLES] __attribute__((aligned(16)));
+static float p_life[MAX_PARTICLES] __attribute__((aligned(16)));
+static uint8_t p_frame[MAX_PARTICLES];
+static uint8_t p_prio[MAX_PARTICLES];
+static int p_count = 0;
+
+// Coarse collision grid, one byte per tile
+static uint8_t cell_class[MAP_HEIGHT][MAP_WIDTH];
+
+// Liquid tiles with open space above, where ambient particles appear
+static struct
+{
+    uint8_t tx, ty;
+    uint8_t tile;
+} hazards[MAX_HAZARDS];
+static int num_hazards = 0;
+static unsigned hazard_timer = 0;
+
+static uint32_t rng_state = 1;
+
+// Small LCG, returns a float in [0, 1)
+static float rand01(void)
+{
+    rng_state = rng_state * 1103515245u + 12345u;
+    return (float)((rng_state >> 8) & 0xFFFF) / 65536.0f;
+}
+
+void particle_init(void)
+{
+    p_count = 0;
+    num_hazards = 0;
+    hazard_timer = 0;
+
+    for (int ty = 0; ty < MAP_HEIGHT; ty++)
+    {
+        for (int tx = 0; tx < MAP_WIDTH; tx++)
+        {
+            int tile = tilemap[ty][tx];
+            if (tile == TILE_FIRE || tile == TILE_WATER || tile == TILE_POISON)
+            {
+                cell_class[ty][tx] = CELL_LIQUID;
+                if (ty > 0 && tilemap[ty - 1][tx] == TILE_EMPTY && num_hazards < MAX_HAZARDS)
+                {
+                    hazards[num_hazards].tx = tx;
+                    hazards[num_hazards].ty = ty;
+                    hazards[num_hazards].tile = tile;
+                    num_hazards++;
+                }
+            }
+            else if (tile == TILE_EMPTY || tile == TILE_GOAL1 || tile == TILE_GOAL2)
+            {
+                cell_class[ty][tx] = CELL_EMPTY;
+            }
+            else
+            {
+                cell_class[ty][tx] = CELL_SOLID; // Walls, slopes and ceilings
+            }
+        }
+    }
+}
+
+bool particle_emit(float x, float y, float vx, float vy,
+                   uint16_t life, uint8_t frame, particle_prio_t prio)
+{
+    if (p_count >= MAX_PARTICLES)
+        return false;
+
+    int i = p_count++;
+    p_x[i] = x;
+    p_y[i] = y;
+    p_vx[i] = vx;
+    p_vy[i] = vy;
+    p_life[i] = life;
+    p_frame[i] = frame;
+    p_prio[i] = prio;
+    return true;
+}
+
+void particle_burst(float x, float y, int count, uint8_t frame, particle_prio_t prio)
+{
+    for (int i = 0; i < count; i++)
+    {
+        float vx = (rand01() - 0.5f) * 3.0f;
+        float vy = -1.0f - rand01() * 2.0f;
+        if (!particle_emit(x, y, vx, vy, 30, frame, prio))
+            break;
+    }
+}
+
+void particle_spawn_hazards(void)
+{
+    if (num_hazards == 0 || ++hazard_timer < HAZARD_SPAWN_PERIOD)
+        return;
+    hazard_timer = 0;
+
+    int h = (int)(rand01() * num_hazards);
+    float x = hazards[h].tx * TILE_SIZE + rand01() * TILE_SIZE;
+    float y = hazards[h].ty * TILE_SIZE + TILE_SIZE / 2;
+    uint8_t frame = (hazards[h].tile == TILE_FIRE) ? PARTICLE_SPARK_FRAME : PARTICLE_SPLASH_FRAME;
+
+    particle_emit(x, y, (rand01() - 0.5f) * 0.6f, -1.5f - rand01(), 24, frame, PARTICLE_PRIO_AMBIENT);
+}
+
+// Branch-free integration over contiguous float arrays
+static void particle_integrate(int n,
+                               float *restrict x, float *restrict y,
+                               float *restrict vx, float *restrict vy,
+                               float *restrict life)
+{
+    for (int i = 0; i < n; i++)
+    {
+        vy[i] += PARTICLE_GRAVITY;
+        vx[i] *= PARTICLE_DRAG;
+        x[i] += vx[i];
+        y[i] += vy[i];
+        life[i] -= 1.0f;
+    }
+}
+
+// One tile lookup per particle: bounce off solid tiles, die in liquids or off the map
+static void particle_collide(int n)
+{
+    for (int i = 0; i < n; i++)
+    {
+        int tx = (int)p_x[i] >> 4;
+        int ty = (int)p_y[i] >> 4;
+
+        if (p_x[i] < 0 || p_y[i] < 0 || tx >= MAP_WIDTH || ty >= MAP_HEIGHT)
+        {
+            p_life[i] = 0;
+            continue;
+        }
+
+        uint8_t c = cell_class[ty][tx];
+        if (c == CELL_SOLID)
+        {
+            // Step back and reflect the vertical motion
+            p_x[i] -= p_vx[i];
+            p_y[i] -= p_vy[i];
+            p_vy[i] = -p_vy[i] * PARTICLE_BOUNCE;
+            p_vx[i] *= PARTICLE_BOUNCE;
+        }
+        else if (c == CELL_LIQUID && p_vy[i] > 0)
+        {
+            p_life[i] = 0; // Fell back into a pool
+        }
+    }
+}
+
+void particle_update(void)
+{
+    particle_integrate(p_count, p_x, p_y, p_vx, p_vy, p_life);
+    particle_collide(p_count);
+
+    // Swap-remove dead particles so the arrays stay dense
+    for (int i = 0; i < p_count;)
+    {
+        if (p_life[i] > 0)
+        {
+            i++;
+            continue;
+        }
+        int last = --p_count;
+        p_x[i] = p_x[last];
+        p_y[i] = p_y[last];
+        p_vx[i] = p_vx[last];
+        p_vy[i] = p_vy[last];
+        p_life[i] = p_life[last];
+        p_frame[i] = p_frame[last];
+        p_prio[i] = p_prio[last];
+    }
+}
+
+int particle_sprite_candidates(uint32_t *words, int max)
+{
+    int n = 0;
+
+    for (int prio = 0; prio < NUM_PARTICLE_PRIOS && n < max; prio++)
+    {
+        for (int i = 0; i < p_count && n < max; i++)
+        {
+            if (p_prio[i] != prio)
+                continue;
+
+            // Particle position is the sprite centre
+            int x = (int)p_x[i] - SPRITE_W_PIXELS / 2;
+            int y = (int)p_y[i] - SPRITE_H_PIXELS / 2;
+            if (x < 0 || y < 0 || x >= 640 || y >= VACTIVE)
+                continue;
+            words[n++] = make_attr_word(1, 0, SPRITE_16x16, x, y, p_frame[i]);
+        }
+    }
+    return n;
+}
+
+int particle_count(void)
+{
+    return p_count;
+}
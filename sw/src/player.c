@@ -25,9 +25,7 @@ void debug_print_player_state(player_t *p, const char *tag)
     printf("[%s] x=%.1f y=%.1f vx=%.2f vy=%.2f on_ground=%d foot_tile=%d (%d,%d)\n",
            tag, p->x, p->y, p->vx, p->vy, p->on_ground, tile, tx, ty);
 }
-void player_init(player_t *p, int x, int y,
-                 uint8_t upper_index, uint8_t lower_index,
-                 player_type_t type)
+void player_init(player_t *p, int x, int y, player_type_t type)
 {
     p->x = x;
     p->y = y;
@@ -35,20 +33,10 @@ void player_init(player_t *p, int x, int y,
     p->on_ground = false;
     p->state = STATE_IDLE;
     p->type = type;
-    p->frame_timer = 0;
-    p->frame_index = 0;
     p->was_on_slope_last_frame = false;
 
-    if (type == PLAYER_FIREBOY)
-    {
-        sprite_set(&p->upper_sprite, upper_index, 0);
-        sprite_set(&p->lower_sprite, lower_index, 0);
-    }
-    else
-    {
-        sprite_set(&p->upper_sprite, upper_index, 0);
-        sprite_set(&p->lower_sprite, lower_index, 0);
-    }
+    sprite_set(&p->upper_sprite, SPRITE_PRIO_PLAYER, 0);
+    sprite_set(&p->lower_sprite, SPRITE_PRIO_PLAYER, 0);
 }
 
 void player_handle_input(player_t *p, int player_index)
@@ -90,10 +78,6 @@ int player_update_physics(player_t *p)
     // Vertical movement
     float tempVy = 0.0f;
     float new_y = p->y + p->vy;
-    if (is_death(p->x, new_y + 1, SPRITE_W_PIXELS, PLAYER_HEIGHT_PIXELS, p->type))
-    {
-        return 1;
-    }
     if (check_both_players_goal())
     {
         return 2;
@@ -335,8 +319,8 @@ void adjust_to_platform_y(player_t *p)
 #define WG_LEG_WALK ((uint8_t)40)         // 0x2800 >> 8 = 40
 #define WG_LEG_UPorDOWNWALK ((uint8_t)43) // 0x2B00 >> 8 = 43
 
-// Called each frame: automatically cycles between walking frames
-static int get_frame_id(player_t *p, bool is_upper)
+// First frame of the current state's cycle
+static int get_frame_base(player_t *p, bool is_upper)
 {
     int base = 0;
 
@@ -363,8 +347,7 @@ static int get_frame_id(player_t *p, bool is_upper)
             base = is_upper ? WG_HEAD_DOWNWALK : WG_LEG_UPorDOWNWALK;
     }
 
-    int frame_count = get_frame_count(p, is_upper);
-    return base + (p->frame_index % frame_count);
+    return base;
 }
 
 int get_frame_count(player_t *p, bool is_upper)
@@ -408,27 +391,15 @@ void player_update_sprite(player_t *p)
         break;
     }
 
-    if (animate)
-    {
-        p->frame_timer++;
-        if (p->frame_timer >= MAX_FRAME_TIMER)
-        {
-            p->frame_timer = 0;
-            int frame_count = get_frame_count(p, true); // Upper body determines frame length
-            p->frame_index = (p->frame_index + 1) % frame_count;
-        }
-    }
-    else
-    {
-        p->frame_index = 0;
-    }
+    // The hardware steps the cycle every MAX_FRAME_TIMER vblanks; only a
+    // state change reaches the animation registers
+    sprite_set_anim(&p->lower_sprite, get_frame_base(p, false),
+                    animate ? get_frame_count(p, false) : 1, MAX_FRAME_TIMER, false);
+    sprite_set_anim(&p->upper_sprite, get_frame_base(p, true),
+                    animate ? get_frame_count(p, true) : 1, MAX_FRAME_TIMER, false);
 
     if (p->type == PLAYER_FIREBOY)
     {
-        // Set frame ID
-        p->lower_sprite.frame_id = get_frame_id(p, false);
-        p->upper_sprite.frame_id = get_frame_id(p, true);
-
         // Set position and enable
         // Body
         p->lower_sprite.x = p->x;
@@ -441,9 +412,6 @@ void player_update_sprite(player_t *p)
     }
     if (p->type == PLAYER_WATERGIRL)
     {
-        p->lower_sprite.frame_id = get_frame_id(p, false);
-        p->upper_sprite.frame_id = get_frame_id(p, true);
-
         p->lower_sprite.x = p->x;
         p->lower_sprite.y = p->y + SPRITE_H_PIXELS - 2;
         p->lower_sprite.enable = true;
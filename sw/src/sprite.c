@@ -1,22 +1,88 @@
 #include "sprite.h"
 #include "hw_interact.h"
+#include "particle.h"
+#include "motion.h"
 #include <math.h> //
 #include "type.h"
 #include <stdio.h>
+#include <string.h>
 
 #define BOX_PUSH_SPEED 0.5f
 #define BOX_FRICTION 0.2f
 
 extern box_t boxes[NUM_BOXES];
 
-void sprite_set(sprite_t *s, uint8_t index, uint8_t frame_count)
+// === Logical sprite pool ===
+// Objects register their sprites here; sprite_commit() maps them onto
+// the hardware attribute table once per frame.
+static uint8_t sprite_prio[SPRITE_POOL_SIZE];
+static uint32_t sprite_stage[SPRITE_POOL_SIZE]; // Last attribute word published for each sprite
+static uint32_t anim_stage[SPRITE_POOL_SIZE];   // Animation word, 0 for a still sprite
+static int8_t motion_stage[SPRITE_POOL_SIZE];   // Linked motion channel, -1 for none
+static uint8_t palette_stage[SPRITE_POOL_SIZE]; // Palette of an indexed sprite
+static uint8_t sprite_pool_count = 0;
+
+// Last word written to each hardware slot, to skip redundant ioctls
+static uint32_t hw_shadow[NUM_HW_SPRITES];
+static uint32_t hw_anim_shadow[NUM_HW_SPRITES];
+static uint8_t hw_palette_shadow[NUM_HW_SPRITES];
+static bool hw_shadow_valid = false;
+
+// Classes that lost sprites last frame get their order rotated
+static bool class_dropped[NUM_SPRITE_PRIOS];
+
+void sprite_pool_reset(void)
+{
+    sprite_pool_count = 0;
+    hw_shadow_valid = false; // Rewrite every slot at the next sprite_commit()
+}
+
+// Reserve `count` consecutive hidden sprites, returns the first id or
+// SPRITE_POOL_SIZE when the pool is full
+static uint8_t sprite_pool_alloc(sprite_prio_t priority, uint8_t count)
+{
+    uint8_t first = sprite_pool_count;
+
+    if (sprite_pool_count + count > SPRITE_POOL_SIZE)
+    {
+        fprintf(stderr, "sprite pool full, sprite will not be displayed\n");
+        return SPRITE_POOL_SIZE;
+    }
+    for (uint8_t i = 0; i < count; i++)
+    {
+        sprite_prio[first + i] = priority;
+        sprite_stage[first + i] = 0;
+        anim_stage[first + i] = 0;
+        motion_stage[first + i] = -1;
+        palette_stage[first + i] = 0;
+    }
+    sprite_pool_count += count;
+    return first;
+}
+
+void sprite_set(sprite_t *s, sprite_prio_t priority, uint8_t frame_count)
 {
-    s->index = index;
     s->x = s->y = 0;
     s->frame_id = 0;
     s->flip = 0;
+    s->size = SPRITE_16x16;
+    s->motion = -1;
+    s->indexed = false;
+    s->palette = 0;
     s->enable = false;
     s->frame_count = frame_count;
+    s->priority = priority;
+    s->index = sprite_pool_alloc(priority, 1);
+}
+
+void sprite_set_anim(sprite_t *s, uint8_t base, uint8_t count,
+                     uint8_t period, bool pingpong)
+{
+    s->frame_start = base;
+    s->frame_count = count;
+    s->frame_id = base;
+    if (s->index < sprite_pool_count)
+        anim_stage[s->index] = count > 1 ? make_anim_word(1, pingpong, base, count, period) : 0;
 }
 
 void sprite_animate(sprite_t *s)
@@ -28,9 +94,17 @@ void sprite_animate(sprite_t *s)
     }
 }
 
+// Stage the sprite for the next sprite_commit()
 void sprite_update(sprite_t *s)
 {
-    write_sprite(s->index, s->enable, s->flip, s->x, s->y, s->frame_id);
+    if (s->index < sprite_pool_count)
+    {
+        sprite_stage[s->index] = make_attr_word(s->enable, s->flip, s->size,
+                                                s->x, s->y, s->frame_id) |
+                                 (s->indexed ? SPRITE_ATTR_INDEXED : 0);
+        motion_stage[s->index] = s->motion;
+        palette_stage[s->index] = s->palette;
+    }
 }
 
 void sprite_clear(sprite_t *s)
@@ -39,14 +113,270 @@ void sprite_clear(sprite_t *s)
     sprite_update(s);
 }
 
-void item_init(item_t *item, float x, float y, uint8_t sprite_index, uint8_t frame_id)
+// Screen position of pool sprite i; a linked sprite is placed from its
+// channel's last known position, which is close enough for culling
+static void sprite_screen_pos(int i, int *x, int *y)
+{
+    uint32_t w = sprite_stage[i];
+
+    *x = (w >> 8) & 0x3FF;
+    *y = (w >> 18) & 0x1FF;
+    if (motion_stage[i] >= 0)
+    {
+        int ox, oy;
+        motion_origin(motion_stage[i], &ox, &oy);
+        *x = (*x + ox) & 0x3FF;
+        *y = (*y + oy) & 0x1FF;
+    }
+}
+
+// Claim the next hardware slot for `w` (animation and motion link word
+// `anim`, palette `palette`, top at screen line `y`) if the slot count and
+// the line budget of every band it covers allow it
+static bool sprite_place(uint32_t w, uint32_t anim, uint8_t palette, int y,
+                         int *slot, uint8_t *band_count)
+{
+    int first = y >> SPRITE_BAND_SHIFT;
+    int h = ((w >> 27) & SPRITE_SIZE_TALL) ? 2 * SPRITE_H_PIXELS : SPRITE_H_PIXELS;
+    int last = (y + h - 1) >> SPRITE_BAND_SHIFT;
+
+    if (*slot >= NUM_HW_SPRITES)
+        return false;
+    if (last >= NUM_SPRITE_BANDS)
+        last = NUM_SPRITE_BANDS - 1;
+    for (int b = first; b <= last; b++)
+        if (band_count[b] >= SPRITE_LINE_BUDGET)
+            return false;
+    for (int b = first; b <= last; b++)
+        band_count[b]++;
+
+    if (!hw_shadow_valid || hw_shadow[*slot] != w)
+    {
+        write_sprite_attr(*slot, w);
+        hw_shadow[*slot] = w;
+    }
+    // Only on change: the hardware restarts an animation when it is written
+    if (!hw_shadow_valid || hw_anim_shadow[*slot] != anim)
+    {
+        write_sprite_anim(*slot, anim);
+        hw_anim_shadow[*slot] = anim;
+    }
+    if ((w & SPRITE_ATTR_INDEXED) &&
+        (!hw_shadow_valid || hw_palette_shadow[*slot] != palette))
+    {
+        write_sprite_palette(*slot, palette);
+        hw_palette_shadow[*slot] = palette;
+    }
+    (*slot)++;
+    return true;
+}
+
+int sprite_commit(void)
+{
+    static uint8_t band_count[NUM_SPRITE_BANDS];
+    static uint32_t particle_words[MAX_PARTICLE_SPRITES];
+    uint8_t order[SPRITE_POOL_SIZE];
+    uint8_t class_start[NUM_SPRITE_PRIOS + 1] = {0};
+    uint8_t n = 0;
+    int slot = 0;
+    int dropped = 0;
+
+    // Count visible sprites per priority class
+    for (int i = 0; i < sprite_pool_count; i++)
+    {
+        int x, y;
+        sprite_screen_pos(i, &x, &y);
+        if (!(sprite_stage[i] >> 31) || x >= 640 || y >= VACTIVE)
+            continue; // Disabled or off-screen
+        class_start[sprite_prio[i] + 1]++;
+    }
+    for (int c = 0; c < NUM_SPRITE_PRIOS; c++)
+        class_start[c + 1] += class_start[c];
+
+    // Bucket by class. A class that lost sprites last frame is rotated so the
+    // drops move around (flicker) instead of the same sprites vanishing; a
+    // class that fits keeps a stable order so its slots don't need rewriting.
+    for (int c = 0; c < NUM_SPRITE_PRIOS; c++)
+    {
+        uint8_t len = class_start[c + 1] - class_start[c];
+        uint8_t k;
+        if (len == 0)
+        {
+            class_dropped[c] = false;
+            continue;
+        }
+        k = class_dropped[c] ? frame_counter % len : 0;
+        class_dropped[c] = false;
+        for (int i = 0; i < sprite_pool_count; i++)
+        {
+            int x, y;
+            sprite_screen_pos(i, &x, &y);
+            if (!(sprite_stage[i] >> 31) || x >= 640 || y >= VACTIVE || sprite_prio[i] != c)
+                continue;
+            order[class_start[c] + k] = i;
+            k = (k + 1) % len;
+        }
+    }
+    n = class_start[NUM_SPRITE_PRIOS];
+
+    memset(band_count, 0, sizeof(band_count));
+    for (int k = 0; k < n; k++)
+    {
+        int i = order[k], x, y;
+        uint32_t ctrl = anim_stage[i];
+        if (motion_stage[i] >= 0)
+            ctrl |= make_motion_link(motion_stage[i]);
+        sprite_screen_pos(i, &x, &y);
+        if (!sprite_place(sprite_stage[i], ctrl, palette_stage[i], y, &slot, band_count))
+        {
+            class_dropped[sprite_prio[i]] = true;
+            dropped++;
+        }
+    }
+
+    // Particles only get whatever slots and line budget gameplay left over;
+    // ones that don't fit are simply not drawn this frame
+    n = particle_sprite_candidates(particle_words, MAX_PARTICLE_SPRITES);
+    for (int k = 0; k < n && slot < NUM_HW_SPRITES; k++)
+        sprite_place(particle_words[k], 0, 0, (particle_words[k] >> 18) & 0x1FF, &slot, band_count);
+
+    // Release the remaining slots
+    for (; slot < NUM_HW_SPRITES; slot++)
+    {
+        if (!hw_shadow_valid || hw_shadow[slot] != 0)
+        {
+            write_sprite_attr(slot, 0);
+            hw_shadow[slot] = 0;
+        }
+    }
+    hw_shadow_valid = true;
+
+    return dropped;
+}
+
+// === Metasprites ===
+// Piece layouts, (dx, dy, frame offset, flip) relative to the object origin
+static const metasprite_piece_t box_pieces[] = {
+    {0, 0, 0, 0, SPRITE_32x32},
+};
+static const metasprite_def_t box_def = {1, 31, box_pieces};
+
+static const metasprite_piece_t elevator_pieces[] = {
+    {1, 0, 0, 0, SPRITE_32x16},  // Left half
+    {32, 0, 2, 0, SPRITE_32x16}, // Right half
+};
+static const metasprite_def_t elevator_def = {2, 63, elevator_pieces};
+
+// Lever frames are relative to LEVER_BASE_FRAME; the handle comes from LEVER_ANIM_FRAME
+#define LEVER_HANDLE(n) (LEVER_ANIM_FRAME - LEVER_BASE_FRAME + (n))
+static const metasprite_piece_t lever_left_pieces[] = {
+    {0, -4, 0, 0, SPRITE_32x16},
+    {5, -16, LEVER_HANDLE(1), 0}, // Middle handle frame
+};
+static const metasprite_piece_t lever_right_pieces[] = {
+    {0, -4, 0, 0, SPRITE_32x16},
+    {13, -16, LEVER_HANDLE(2), 0}, // Handle tilted right
+};
+static const metasprite_def_t lever_left_def = {2, 32, lever_left_pieces};
+static const metasprite_def_t lever_right_def = {2, 32, lever_right_pieces};
+
+// 15 px apart, so the lever base frames can't be drawn as one wide sprite here
+static const metasprite_piece_t button_base_pieces[] = {
+    {-8, 13, 0, 0}, // Left base
+    {7, 13, 1, 0},  // Right base
+};
+static const metasprite_def_t button_base_def = {2, 16, button_base_pieces};
+
+// Generate the attribute words of every piece straight into the staging table
+static void metasprite_stage(const metasprite_t *ms)
+{
+    const metasprite_def_t *def = ms->def;
+    uint32_t *out;
+    uint8_t i = 0;
+
+    if (ms->first >= SPRITE_POOL_SIZE)
+        return;
+    out = &sprite_stage[ms->first];
+    for (; i < def->count; i++)
+    {
+        const metasprite_piece_t *pc = &def->pieces[i];
+        int w = (pc->size & SPRITE_SIZE_WIDE) ? 2 * SPRITE_W_PIXELS : SPRITE_W_PIXELS;
+        int dx = ms->flip ? def->width - w - pc->dx : pc->dx;
+        out[i] = make_attr_word(ms->enable, pc->flip ^ ms->flip, pc->size,
+                                ms->x + dx, ms->y + pc->dy,
+                                ms->base_frame + pc->frame);
+    }
+    for (; i < ms->count; i++)
+        out[i] = 0; // Reserved pieces the current def doesn't use
+    for (i = 0; i < ms->count; i++)
+        motion_stage[ms->first + i] = ms->motion;
+}
+
+void metasprite_init(metasprite_t *ms, const metasprite_def_t *def,
+                     sprite_prio_t priority, uint8_t base_frame,
+                     uint16_t x, uint16_t y)
+{
+    ms->def = def;
+    ms->count = def->count;
+    ms->first = sprite_pool_alloc(priority, def->count);
+    ms->base_frame = base_frame;
+    ms->x = x;
+    ms->y = y;
+    ms->flip = false;
+    ms->enable = true;
+    ms->motion = -1;
+    metasprite_stage(ms);
+}
+
+void metasprite_set_def(metasprite_t *ms, const metasprite_def_t *def)
+{
+    if (def->count > ms->count)
+        return; // Would overrun the pieces reserved at init
+    ms->def = def;
+    metasprite_stage(ms);
+}
+
+void metasprite_move(metasprite_t *ms, uint16_t x, uint16_t y)
+{
+    ms->x = x;
+    ms->y = y;
+    metasprite_stage(ms);
+}
+
+void metasprite_set_flip(metasprite_t *ms, bool flip)
+{
+    ms->flip = flip;
+    metasprite_stage(ms);
+}
+
+void metasprite_show(metasprite_t *ms, bool enable)
+{
+    ms->enable = enable;
+    metasprite_stage(ms);
+}
+
+void metasprite_link_motion(metasprite_t *ms, int8_t ch)
+{
+    ms->motion = ch;
+    ms->x = ms->y = 0;
+    metasprite_stage(ms);
+}
+
+void sprite_link_motion(sprite_t *s, int8_t ch)
+{
+    s->motion = ch;
+    s->x = s->y = 0;
+    sprite_update(s);
+}
+
+void item_init(item_t *item, float x, float y, uint8_t frame_id)
 {
     item->x = x;
     item->y = y;
     item->width = 16;
     item->height = 16;
     item->active = true;
-    sprite_set(&item->sprite, sprite_index, 0);
+    sprite_set(&item->sprite, SPRITE_PRIO_ITEM, 0);
     item->sprite.x = (uint16_t)x;
     item->sprite.y = (uint16_t)y;
     item->sprite.frame_id = frame_id;
@@ -58,14 +388,25 @@ void item_update_sprite(item_t *item)
 {
     if (item->active)
     {
-        float offset = 0.0f;
-        if (item->float_anim)
+        // Floating gems bob 2 px either side of their spot in hardware,
+        // set up on the first update once the item has been placed
+        if (item->float_anim && item->sprite.motion < 0)
         {
-            offset = 0.01f * sinf((float)frame_counter * 0.1f + item->sprite.index); // Different amplitude and frequency for floating animation
+            int8_t ch = motion_alloc();
+            if (ch >= 0)
+            {
+                motion_setup(ch, item->x, item->y - 2,
+                             MOTION_FREE, item->x, item->x,
+                             MOTION_OSCILLATE, item->y - 2, item->y + 2);
+                sprite_link_motion(&item->sprite, ch);
+            }
         }
 
-        item->sprite.x = (uint16_t)item->x;
-        item->sprite.y = (uint16_t)(item->y + offset);
+        if (item->sprite.motion < 0)
+        {
+            item->sprite.x = (uint16_t)item->x;
+            item->sprite.y = (uint16_t)item->y;
+        }
         item->sprite.enable = true;
         sprite_update(&item->sprite);
     }
@@ -75,7 +416,7 @@ void item_update_sprite(item_t *item)
     }
 }
 
-void box_init(box_t *b, int tile_x, int tile_y, int sprite_base_index, uint8_t frame_id)
+void box_init(box_t *b, int tile_x, int tile_y, uint8_t frame_id)
 
 {
     b->x = tile_x * 16;
@@ -83,35 +424,13 @@ void box_init(box_t *b, int tile_x, int tile_y, int sprite_base_index, uint8_t f
     b->vx = 0;
     b->active = true;
 
-    for (int i = 0; i < 4; i++)
-    {
-        sprite_set(&b->sprites[i], sprite_base_index + i, 1);
-        b->sprites[i].frame_id = frame_id + i;
-        b->sprites[i].enable = true;
-    }
+    metasprite_init(&b->body, &box_def, SPRITE_PRIO_MECHANISM, frame_id,
+                    (uint16_t)b->x, (uint16_t)b->y);
 }
 
 void box_update_sprite(box_t *b)
 {
-    float x = b->x;
-    float y = b->y;
-
-    b->sprites[0].x = x;
-    b->sprites[0].y = y + 1;
-
-    b->sprites[1].x = x + 15;
-    b->sprites[1].y = y + 1;
-
-    b->sprites[2].x = x;
-    b->sprites[2].y = y + 16;
-
-    b->sprites[3].x = x + 15;
-    b->sprites[3].y = y + 16;
-
-    for (int i = 0; i < 4; i++)
-    {
-        sprite_update(&b->sprites[i]);
-    }
+    metasprite_move(&b->body, (uint16_t)b->x, (uint16_t)b->y);
 }
 
 void box_try_push(box_t *box, const player_t *p)
@@ -222,45 +541,15 @@ bool check_overlap(float x1, float y1, float w1, float h1,
            (y1 < y2 + h2) && (y1 + h1 > y2);
 }
 
-void lever_init(lever_t *lvr, float tile_x, float tile_y, uint8_t sprite_index_base)
+void lever_init(lever_t *lvr, float tile_x, float tile_y)
 {
     lvr->x = tile_x * 16;
     lvr->y = tile_y * 16;
     lvr->activated = false;
-    lvr->sprite_base_index = sprite_index_base;
-
-    // Frame resource definitions
-    lvr->base_frame[0] = LEVER_BASE_FRAME + 0;
-    lvr->base_frame[1] = LEVER_BASE_FRAME + 1;
-    lvr->handle_frames[0] = LEVER_ANIM_FRAME + 0; // ←
-    lvr->handle_frames[1] = LEVER_ANIM_FRAME + 1; // Middle
-    lvr->handle_frames[2] = LEVER_ANIM_FRAME + 2; // →
-
-    // Set up base sprites (2 tiles)
-    for (int i = 0; i < 2; ++i)
-    {
-        sprite_set(&lvr->base_sprites[i], sprite_index_base + i, 0);
-        lvr->base_sprites[i].x = (uint16_t)(lvr->x + i * 16);
-        lvr->base_sprites[i].y = (uint16_t)(lvr->y - 4);
-        lvr->base_sprites[i].frame_id = lvr->base_frame[i];
-        lvr->base_sprites[i].enable = true;
-        sprite_update(&lvr->base_sprites[i]);
-    }
-
-    // Set up lever handle
-    sprite_set(&lvr->handle_sprite_left, sprite_index_base + 2, 0);
-    lvr->handle_sprite_left.x = (uint16_t)(lvr->x + 5);
-    lvr->handle_sprite_left.y = (uint16_t)(lvr->y - 16);
-    lvr->handle_sprite_left.frame_id = lvr->handle_frames[1]; // Middle frame
-    lvr->handle_sprite_left.enable = false;
-    sprite_update(&lvr->handle_sprite_left);
-    // Set up lever handle
-    sprite_set(&lvr->handle_sprite_right, sprite_index_base + 3, 0);
-    lvr->handle_sprite_right.x = (uint16_t)(lvr->x + 13);
-    lvr->handle_sprite_right.y = (uint16_t)(lvr->y - 16);
-    lvr->handle_sprite_right.frame_id = lvr->handle_frames[2]; // Middle frame
-    lvr->handle_sprite_right.enable = true;
-    sprite_update(&lvr->handle_sprite_right);
+
+    // Base (2 tiles) plus the handle in its right position
+    metasprite_init(&lvr->body, &lever_right_def, SPRITE_PRIO_MECHANISM, LEVER_BASE_FRAME,
+                    (uint16_t)lvr->x, (uint16_t)lvr->y);
 }
 
 void lever_update(lever_t *lvr, const player_t *players)
@@ -278,10 +567,7 @@ void lever_update(lever_t *lvr, const player_t *players)
         if (!lvr->activated && px >= lvr->x + 20 && px <= lvr->x + 28 && p->vx < -0.3f)
         {
             lvr->activated = true;
-            lvr->handle_sprite_left.enable = true;
-            lvr->handle_sprite_right.enable = false;
-            sprite_update(&lvr->handle_sprite_left);
-            sprite_update(&lvr->handle_sprite_right);
+            metasprite_set_def(&lvr->body, &lever_left_def);
             break;
         }
 
@@ -289,16 +575,13 @@ void lever_update(lever_t *lvr, const player_t *players)
         if (lvr->activated && px >= lvr->x + 4 && px <= lvr->x + 12 && p->vx > 0.3f)
         {
             lvr->activated = false;
-            lvr->handle_sprite_left.enable = false;
-            lvr->handle_sprite_right.enable = true;
-            sprite_update(&lvr->handle_sprite_left);
-            sprite_update(&lvr->handle_sprite_right);
+            metasprite_set_def(&lvr->body, &lever_right_def);
             break;
         }
     }
 }
 
-void elevator_init(elevator_t *elv, float tile_x, float tile_y, float min_tile_y, float max_tile_y, uint8_t sprite_index_base, uint8_t frame_index)
+void elevator_init(elevator_t *elv, float tile_x, float tile_y, float min_tile_y, float max_tile_y, uint8_t frame_index)
 {
     float x = tile_x * 16;
     float y = tile_y * 16;
@@ -310,39 +593,17 @@ void elevator_init(elevator_t *elv, float tile_x, float tile_y, float min_tile_y
     elv->vy = 0.0f;
     elv->moving_up = true;
     elv->active = false;
-    elv->sprite_base_index = sprite_index_base;
-
-    // Left block
-    sprite_set(&elv->sprites[0], sprite_index_base + 0, 0);
-    elv->sprites[0].x = (uint16_t)(x + 1);
-    elv->sprites[0].y = (uint16_t)(y);
-    elv->sprites[0].frame_id = frame_index + 0;
-    elv->sprites[0].enable = true;
-    sprite_update(&elv->sprites[0]);
-
-    // Left middle block
-    sprite_set(&elv->sprites[1], sprite_index_base + 1, 0);
-    elv->sprites[1].x = (uint16_t)(x + 16);
-    elv->sprites[1].y = (uint16_t)(y);
-    elv->sprites[1].frame_id = frame_index + 1;
-    elv->sprites[1].enable = true;
-    sprite_update(&elv->sprites[1]);
-
-    // Right middle block
-    sprite_set(&elv->sprites[2], sprite_index_base + 2, 0);
-    elv->sprites[2].x = (uint16_t)(x + 32);
-    elv->sprites[2].y = (uint16_t)(y);
-    elv->sprites[2].frame_id = frame_index + 2;
-    elv->sprites[2].enable = true;
-    sprite_update(&elv->sprites[2]);
-
-    // Right block
-    sprite_set(&elv->sprites[3], sprite_index_base + 3, 0);
-    elv->sprites[3].x = (uint16_t)(x + 47);
-    elv->sprites[3].y = (uint16_t)(y);
-    elv->sprites[3].frame_id = frame_index + 3;
-    elv->sprites[3].enable = true;
-    sprite_update(&elv->sprites[3]);
+
+    metasprite_init(&elv->body, &elevator_def, SPRITE_PRIO_MECHANISM, frame_index,
+                    (uint16_t)x, (uint16_t)y);
+
+    // The hardware moves the body between the stops; software only sets the velocity
+    int8_t ch = motion_alloc();
+    if (ch >= 0)
+    {
+        motion_setup(ch, x, y, MOTION_FREE, x, x, MOTION_STOP, elv->min_y, elv->max_y);
+        metasprite_link_motion(&elv->body, ch);
+    }
 }
 bool is_elevator_blocked(float x, float y, float w, float h, float *vy_out)
 {
@@ -350,25 +611,31 @@ bool is_elevator_blocked(float x, float y, float w, float h, float *vy_out)
     {
         elevator_t *elv = &elevators[i];
 
-        for (int j = 0; j < 4; j++)
-        {
-            sprite_t *s = &elv->sprites[j];
-
-            float ex = s->x;
-            float ey = s->y;
+        // The two 32x16 pieces form one contiguous strip from dx = 1 to dx = 63
+        float ex = elv->x + 1;
+        float ey = elv->y;
 
-            if (check_overlap(x, y, w, h, ex, ey, 16, 16))
-            {
-                if (vy_out)
-                    *vy_out = elv->vy; // Return elevator vertical speed (for synchronization)
-                return true;
-            }
+        if (check_overlap(x, y, w, h, ex, ey, 62, 16))
+        {
+            if (vy_out)
+                *vy_out = elv->vy; // Return elevator vertical speed (for synchronization)
+            return true;
         }
     }
     return false;
 }
 void elevator_update(elevator_t *elv, bool go_up, player_t *players)
 {
+    float moved = 0.0f;
+
+    // A linked body moved by itself since the last update; catch up with it
+    if (elv->body.motion >= 0)
+    {
+        float x, prev_y = elv->y;
+        motion_read(elv->body.motion, &x, &elv->y);
+        moved = elv->y - prev_y;
+    }
+
     // Determine target direction
     if (!go_up)
     {
@@ -419,16 +686,20 @@ void elevator_update(elevator_t *elv, bool go_up, player_t *players)
         if (will_collide_with_player)
         {
             elv->vy = 0;
+            motion_set_velocity(elv->body.motion, 0.0f, 0.0f);
             return;
         }
     }
     // Apply movement
-    elv->y += elv->vy;
-
-    for (int i = 0; i < 4; ++i)
+    if (elv->body.motion >= 0)
+    {
+        motion_set_velocity(elv->body.motion, 0.0f, elv->vy);
+    }
+    else
     {
-        elv->sprites[i].y = (uint16_t)(elv->y);
-        sprite_update(&elv->sprites[i]);
+        elv->y += elv->vy;
+        metasprite_move(&elv->body, elv->body.x, (uint16_t)(elv->y));
+        moved = elv->vy;
     }
 
     // Player movement synchronization
@@ -441,12 +712,12 @@ void elevator_update(elevator_t *elv, bool go_up, player_t *players)
         if (px >= elv->x && px <= elv->x + 64 &&
             fabsf(foot_y - elv->y) < 4.0f)
         {
-            p->y += elv->vy;
+            p->y += moved;
         }
     }
 }
 
-void button_init(button_t *btn, float tile_x, float tile_y, uint8_t sprite_index_base)
+void button_init(button_t *btn, float tile_x, float tile_y)
 {
     float x = tile_x * 16;
     float y = tile_y * 16 - 16; // Top position of button sprite's upper-left corner
@@ -454,36 +725,22 @@ void button_init(button_t *btn, float tile_x, float tile_y, uint8_t sprite_index
     btn->x = x;
     btn->y = y;
     btn->pressed = false;
-    btn->sprite_index_base = sprite_index_base;
+    btn->press_offset = 0.0f;
 
     // Fixed frame numbers
-    btn->frame_top = BUTTON_PURPLE_FRAME;         // 55
-    btn->frame_base_left = LEVER_BASE_FRAME;      // 57
-    btn->frame_base_right = LEVER_BASE_FRAME + 1; // 60
+    btn->frame_top = BUTTON_PURPLE_FRAME; // 55
 
     // Upper button
-    sprite_set(&btn->top_sprite, sprite_index_base + 0, 0);
+    sprite_set(&btn->top_sprite, SPRITE_PRIO_MECHANISM, 0);
     btn->top_sprite.x = (uint16_t)x;
     btn->top_sprite.y = (uint16_t)y + 2;
     btn->top_sprite.frame_id = btn->frame_top;
     btn->top_sprite.enable = true;
     sprite_update(&btn->top_sprite);
 
-    // Left base
-    sprite_set(&btn->base_left_sprite, sprite_index_base + 1, 0);
-    btn->base_left_sprite.x = (uint16_t)x - 8;
-    btn->base_left_sprite.y = (uint16_t)(y + 13);
-    btn->base_left_sprite.frame_id = btn->frame_base_left;
-    btn->base_left_sprite.enable = true;
-    sprite_update(&btn->base_left_sprite);
-
-    // Right base
-    sprite_set(&btn->base_right_sprite, sprite_index_base + 2, 0);
-    btn->base_right_sprite.x = (uint16_t)(x + 7);
-    btn->base_right_sprite.y = (uint16_t)(y + 13);
-    btn->base_right_sprite.frame_id = btn->frame_base_right;
-    btn->base_right_sprite.enable = true;
-    sprite_update(&btn->base_right_sprite);
+    // Left and right base share the lever base frames
+    metasprite_init(&btn->base, &button_base_def, SPRITE_PRIO_MECHANISM, LEVER_BASE_FRAME,
+                    (uint16_t)x, (uint16_t)y);
 }
 
 void button_update(button_t *btn, const player_t *players)
@@ -0,0 +1,254 @@
+// trigger.c
+// Event-driven wiring between sensors (levers, buttons) and actuators (elevators)
+#include "trigger.h"
+#include "sprite.h"
+#include "type.h"
+#include <stdio.h>
+
+typedef struct
+{
+    uint8_t kind;
+    uint8_t idx;
+    bool state;   // Last reported on/off state
+    float x0, y0; // Wake rectangle, padded by SENSOR_WAKE_MARGIN
+    float x1, y1;
+    uint8_t actuators[MAX_ACTUATORS];
+    uint8_t num_actuators;
+    unsigned stamp; // Last update in which this sensor was evaluated
+} sensor_node_t;
+
+typedef struct
+{
+    uint8_t kind;
+    uint8_t idx;
+    bool input; // OR of linked sensor states
+    bool awake;
+    uint8_t sensors[MAX_SENSORS];
+    uint8_t num_sensors;
+} actuator_node_t;
+
+static sensor_node_t sensors[MAX_SENSORS];
+static actuator_node_t actuators[MAX_ACTUATORS];
+static int num_sensors = 0;
+static int num_actuators = 0;
+
+// Sensors bucketed by the tile rows their wake rectangle covers
+#define MAX_SENSORS_PER_ROW 4
+static uint8_t row_sensors[MAP_HEIGHT][MAX_SENSORS_PER_ROW];
+static uint8_t row_count[MAP_HEIGHT];
+
+// Sensors that must be re-evaluated even with no player nearby (pressed buttons)
+static uint8_t engaged[MAX_SENSORS];
+static int num_engaged = 0;
+
+static uint8_t awake[MAX_ACTUATORS];
+static int num_awake = 0;
+
+static unsigned update_stamp = 0;
+
+static int find_or_add_sensor(uint8_t kind, uint8_t idx)
+{
+    for (int i = 0; i < num_sensors; i++)
+        if (sensors[i].kind == kind && sensors[i].idx == idx)
+            return i;
+    if (num_sensors >= MAX_SENSORS)
+        return -1;
+
+    sensor_node_t *s = &sensors[num_sensors];
+    s->kind = kind;
+    s->idx = idx;
+    s->num_actuators = 0;
+    s->stamp = 0;
+    if (kind == SENSOR_LEVER)
+    {
+        // lever_update() looks at the player's centre and p->y + 32
+        s->state = levers[idx].activated;
+        s->x0 = levers[idx].x;
+        s->x1 = levers[idx].x + 32;
+        s->y0 = levers[idx].y - 32;
+        s->y1 = levers[idx].y;
+    }
+    else
+    {
+        // button_update() looks at the player's centre and feet
+        s->state = buttons[idx].pressed;
+        s->x0 = buttons[idx].x;
+        s->x1 = buttons[idx].x + 16;
+        s->y0 = buttons[idx].y - PLAYER_HEIGHT_PIXELS;
+        s->y1 = buttons[idx].y + 16;
+    }
+    s->x0 -= SENSOR_WAKE_MARGIN;
+    s->y0 -= SENSOR_WAKE_MARGIN;
+    s->x1 += SENSOR_WAKE_MARGIN;
+    s->y1 += SENSOR_WAKE_MARGIN;
+    return num_sensors++;
+}
+
+static int find_or_add_actuator(uint8_t kind, uint8_t idx)
+{
+    for (int i = 0; i < num_actuators; i++)
+        if (actuators[i].kind == kind && actuators[i].idx == idx)
+            return i;
+    if (num_actuators >= MAX_ACTUATORS)
+        return -1;
+
+    actuator_node_t *a = &actuators[num_actuators];
+    a->kind = kind;
+    a->idx = idx;
+    a->input = false;
+    a->awake = false;
+    a->num_sensors = 0;
+    return num_actuators++;
+}
+
+static void wake_actuator(int a)
+{
+    if (!actuators[a].awake)
+    {
+        actuators[a].awake = true;
+        awake[num_awake++] = a;
+    }
+}
+
+// Edge event from sensor `s`: recompute the inputs of its actuators
+static void sensor_changed(int s)
+{
+    for (int k = 0; k < sensors[s].num_actuators; k++)
+    {
+        actuator_node_t *a = &actuators[sensors[s].actuators[k]];
+        bool input = false;
+        for (int j = 0; j < a->num_sensors; j++)
+            input |= sensors[a->sensors[j]].state;
+        if (input != a->input)
+        {
+            a->input = input;
+            wake_actuator(sensors[s].actuators[k]);
+        }
+    }
+}
+
+void trigger_load(const trigger_link_t *links, int count)
+{
+    num_sensors = num_actuators = num_engaged = num_awake = 0;
+    update_stamp = 0;
+    for (int r = 0; r < MAP_HEIGHT; r++)
+        row_count[r] = 0;
+
+    for (int i = 0; i < count && i < MAX_TRIGGER_LINKS; i++)
+    {
+        int s = find_or_add_sensor(links[i].sensor_kind, links[i].sensor);
+        int a = find_or_add_actuator(links[i].actuator_kind, links[i].actuator);
+        if (s < 0 || a < 0)
+        {
+            fprintf(stderr, "trigger graph too large, link %d ignored\n", i);
+            continue;
+        }
+        sensors[s].actuators[sensors[s].num_actuators++] = a;
+        actuators[a].sensors[actuators[a].num_sensors++] = s;
+    }
+
+    for (int s = 0; s < num_sensors; s++)
+    {
+        int r0 = (int)(sensors[s].y0 / TILE_SIZE);
+        int r1 = (int)(sensors[s].y1 / TILE_SIZE);
+        for (int r = r0 < 0 ? 0 : r0; r <= r1 && r < MAP_HEIGHT; r++)
+        {
+            if (row_count[r] < MAX_SENSORS_PER_ROW)
+                row_sensors[r][row_count[r]++] = s;
+        }
+        sensor_changed(s);
+    }
+
+    // Let every actuator settle at the bound its initial input selects
+    for (int a = 0; a < num_actuators; a++)
+        wake_actuator(a);
+}
+
+static void evaluate_sensor(int s, player_t *players)
+{
+    sensor_node_t *node = &sensors[s];
+    bool state;
+
+    if (node->stamp == update_stamp)
+        return;
+    node->stamp = update_stamp;
+
+    if (node->kind == SENSOR_LEVER)
+    {
+        lever_update(&levers[node->idx], players);
+        state = levers[node->idx].activated;
+    }
+    else
+    {
+        button_t *btn = &buttons[node->idx];
+        bool was_engaged = btn->pressed || btn->press_offset > 0.0f;
+        button_update(btn, players);
+        state = btn->pressed;
+
+        // Keep watching a button until it has fully popped back up
+        if (!was_engaged && (btn->pressed || btn->press_offset > 0.0f))
+            engaged[num_engaged++] = s;
+    }
+
+    if (state != node->state)
+    {
+        node->state = state;
+        sensor_changed(s);
+    }
+}
+
+void trigger_update(player_t *players)
+{
+    update_stamp++;
+
+    // 1. Sensors in the tile rows around each player
+    for (int i = 0; i < NUM_PLAYERS; i++)
+    {
+        float px0 = players[i].x;
+        float py0 = players[i].y;
+        float px1 = px0 + SPRITE_W_PIXELS;
+        float py1 = py0 + PLAYER_HEIGHT_PIXELS;
+        int r0 = (int)(py0 / TILE_SIZE);
+        int r1 = (int)(py1 / TILE_SIZE);
+
+        for (int r = r0 < 0 ? 0 : r0; r <= r1 && r < MAP_HEIGHT; r++)
+        {
+            for (int k = 0; k < row_count[r]; k++)
+            {
+                sensor_node_t *node = &sensors[row_sensors[r][k]];
+                if (px1 > node->x0 && px0 < node->x1 && py1 > node->y0 && py0 < node->y1)
+                    evaluate_sensor(row_sensors[r][k], players);
+            }
+        }
+    }
+
+    // 2. Buttons still pressed in from an earlier frame
+    for (int k = 0; k < num_engaged;)
+    {
+        int s = engaged[k];
+        button_t *btn = &buttons[sensors[s].idx];
+        evaluate_sensor(s, players);
+        if (!btn->pressed && btn->press_offset <= 0.0f)
+            engaged[k] = engaged[--num_engaged];
+        else
+            k++;
+    }
+
+    // 3. Actuators woken by edge events, asleep again once at rest
+    for (int k = 0; k < num_awake;)
+    {
+        actuator_node_t *a = &actuators[awake[k]];
+        elevator_t *elv = &elevators[a->idx];
+
+        elevator_update(elv, a->input, players);
+        if (elv->vy == 0.0f && elv->y == (a->input ? elv->max_y : elv->min_y))
+        {
+            a->awake = false;
+            awake[k] = awake[--num_awake];
+        }
+        else
+        {
+            k++;
+        }
+    }
+}
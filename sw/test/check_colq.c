@@ -0,0 +1,78 @@
+/**
+ * @file check_colq.c
+ * @brief Cross-check of the collision query tables against the float probes
+ *
+ * Builds the query tables for the level with colq_load() and compares
+ * colq_query_sw() with is_tile_blocked() and is_death() for a player box
+ * at every quarter pixel of the map and a tile beyond it. The hardware unit
+ * walks the same tables, so a clean run also covers its answers. Runs
+ * without the VGA device.
+ */
+
+#include "../include/colq.h"
+#include "../include/hw_interact.h"
+#include "../include/tilemap.h"
+#include <stdio.h>
+
+// tilemap.c reads the players for goal checks; nothing here uses them
+player_t players[NUM_PLAYERS];
+
+// No device: colq_load() keeps its tables and answers in software
+int write_colq_classes(const vga_top_colq_classes_arg_t *classes)
+{
+    (void)classes;
+    return -1;
+}
+
+int write_colq_map(uint16_t cell, uint16_t count, const uint8_t *classes)
+{
+    (void)cell;
+    (void)count;
+    (void)classes;
+    return -1;
+}
+
+int colq_query_batch(const uint32_t *query, uint32_t *result, uint8_t count)
+{
+    (void)query;
+    (void)result;
+    (void)count;
+    return -1;
+}
+
+int main(void)
+{
+    long checked = 0, mismatches = 0;
+
+    colq_load();
+
+    for (float y = -TILE_SIZE; y < MAP_HEIGHT * TILE_SIZE; y += 0.25f)
+    {
+        for (float x = -TILE_SIZE; x < MAP_WIDTH * TILE_SIZE; x += 0.25f)
+        {
+            colq_box_t box = colq_player_box(x, y, SPRITE_W_PIXELS, PLAYER_HEIGHT_PIXELS);
+            colq_result_t r;
+            colq_query_sw(&box, &r, 1);
+
+            bool blocked = is_tile_blocked(x, y, SPRITE_W_PIXELS, PLAYER_HEIGHT_PIXELS);
+            bool fire = is_death(x, y, SPRITE_W_PIXELS, PLAYER_HEIGHT_PIXELS, PLAYER_FIREBOY);
+            bool water = is_death(x, y, SPRITE_W_PIXELS, PLAYER_HEIGHT_PIXELS, PLAYER_WATERGIRL);
+
+            if (r.blocked != blocked ||
+                ((r.hazard & COLQ_HAZARD_FIREBOY) != 0) != fire ||
+                ((r.hazard & COLQ_HAZARD_WATERGIRL) != 0) != water)
+            {
+                if (mismatches < 10)
+                    printf("mismatch at (%.2f, %.2f): blocked %d/%d, fireboy %d/%d, watergirl %d/%d\n",
+                           x, y, r.blocked, blocked,
+                           (r.hazard & COLQ_HAZARD_FIREBOY) != 0, fire,
+                           (r.hazard & COLQ_HAZARD_WATERGIRL) != 0, water);
+                mismatches++;
+            }
+            checked++;
+        }
+    }
+
+    printf("%ld positions checked, %ld mismatches\n", checked, mismatches);
+    return mismatches != 0;
+}